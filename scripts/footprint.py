@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""
+Reports how much flash and RAM the gestures take in every configuration of
+compile_tests/build.yaml, per source file.
+
+Run it from the root of a west workspace set up with compile_tests/config/west.yml.
+Every configuration is built into build/<board>-<shield> first, unless --no-build
+is given. The sizes are read from the linker map, so sections that the linker
+removed because no gestures instance uses them aren't counted.
+
+    scripts/footprint.py --config compile_tests/config --build-yaml compile_tests/build.yaml
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+import yaml
+
+SOURCE = re.compile(r"\((\w+)\.c\.obj\)$")
+MODULE = "gestures"
+FLASH = ("text", "rodata")
+RAM = ("data", "bss", "noinit")
+COLUMNS = FLASH + RAM
+
+
+def configurations(build_yaml):
+    with open(build_yaml) as f:
+        for entry in yaml.safe_load(f)["include"]:
+            yield entry["board"], entry.get("shield"), entry.get("snippet")
+
+
+def build(board, shield, snippet, config, build_dir):
+    command = ["west", "build", "-p", "auto", "-s", "zmk/app", "-d", str(build_dir), "-b", board]
+    for name in (snippet or "").split():
+        command += ["-S", name]
+    command += ["--", f"-DZMK_CONFIG={config.resolve()}"]
+    if shield:
+        command.append(f"-DSHIELD={shield}")
+    return subprocess.run(command, stdout=subprocess.DEVNULL).returncode == 0
+
+
+def section_kind(name):
+    for kind in COLUMNS:
+        if name.startswith("." + kind) or (name.startswith("COMMON") and kind == "bss"):
+            return kind
+    return None
+
+
+def read_map(map_file):
+    """Sums the sizes of the input sections that were linked, per source file of the gestures."""
+    sizes = defaultdict(lambda: dict.fromkeys(COLUMNS, 0))
+    linked = False
+    pending = None
+
+    with open(map_file) as f:
+        for line in f:
+            if line.startswith("Linker script and memory map"):
+                linked = True
+                continue
+            if not linked:
+                continue
+
+            fields = line.split()
+            # long section names are on a line of their own, followed by address, size and file
+            if len(fields) == 1 and line.startswith(" ."):
+                pending = fields[0]
+                continue
+            if pending and len(fields) == 3 and fields[0].startswith("0x"):
+                fields = [pending] + fields
+            pending = None
+
+            if len(fields) != 4 or not fields[1].startswith("0x") or MODULE not in fields[3]:
+                continue
+            source = SOURCE.search(fields[3])
+            kind = section_kind(fields[0])
+            if source and kind:
+                sizes[source.group(1)][kind] += int(fields[2], 16)
+
+    return sizes
+
+
+def print_report(name, sizes):
+    print(f"\n{name}")
+    if not sizes:
+        print("    no gestures linked")
+        return
+    print(f"    {'file':<28}" + "".join(f"{column:>8}" for column in COLUMNS))
+    total = dict.fromkeys(COLUMNS, 0)
+    for source in sorted(sizes):
+        print(f"    {source:<28}" + "".join(f"{sizes[source][column]:>8}" for column in COLUMNS))
+        for column in COLUMNS:
+            total[column] += sizes[source][column]
+    print(f"    {'total':<28}" + "".join(f"{total[column]:>8}" for column in COLUMNS))
+    print(f"    flash: {sum(total[c] for c in FLASH)} bytes, ram: {sum(total[c] for c in RAM)} bytes")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--build-yaml", type=Path, default=Path("compile_tests/build.yaml"))
+    parser.add_argument("--config", type=Path, default=Path("compile_tests/config"), help="ZMK_CONFIG directory")
+    parser.add_argument("--build-root", type=Path, default=Path("build"))
+    parser.add_argument("--no-build", action="store_true", help="only read the maps of earlier builds")
+    args = parser.parse_args()
+
+    failed = False
+    for board, shield, snippet in configurations(args.build_yaml):
+        name = f"{board}-{shield}" if shield else board
+        build_dir = args.build_root / name
+        if not args.no_build and not build(board, shield, snippet, args.config, build_dir):
+            print(f"\n{name}\n    build failed")
+            failed = True
+            continue
+
+        map_file = build_dir / "zephyr" / "zephyr.map"
+        if not map_file.exists():
+            print(f"\n{name}\n    no linker map in {build_dir}")
+            failed = True
+            continue
+        print_report(name, read_map(map_file))
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
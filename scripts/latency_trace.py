@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""
+Decodes the latency trace logged with CONFIG_INPUT_GESTURES_LATENCY_TRACE=y, see
+src/latency_trace.h for the format. Consecutive dumps continue each other.
+
+    scripts/latency_trace.py usb-log.txt                 # latency from events to reports
+    scripts/latency_trace.py --records usb-log.txt       # every record with its time
+    scripts/latency_trace.py --replay usb-log.txt | scripts/trace_to_dtsi.py > my_trace.dtsi
+"""
+
+import argparse
+import re
+import sys
+
+DUMP_LINE = re.compile(r"latency trace: (begin (\d+) (\d+) (\d+)|data ([0-9a-f]+)|end)")
+
+EVENT, DECISION, REPORT = range(3)
+KIND_BITS = 3
+
+# enum trace_replay_decision
+DECISIONS = [
+    "touch start",
+    "touch end",
+    "tap",
+    "tap drag",
+    "inertial cursor",
+    "circular scroll",
+    "edge scroll",
+    "kinetic scroll",
+]
+
+
+def read_dumps(lines):
+    """Yields (cycles per second, dropped records, bytes) for every complete dump."""
+    dump = None
+    for line in lines:
+        match = DUMP_LINE.search(line)
+        if not match:
+            continue
+        if match.group(2):
+            dump = (int(match.group(2)), int(match.group(4)), bytearray())
+        elif match.group(5) and dump:
+            dump[2].extend(bytes.fromhex(match.group(5)))
+        elif match.group(1) == "end" and dump:
+            yield dump
+            dump = None
+
+
+def read_varint(data, index):
+    value, shift = 0, 0
+    while True:
+        byte = data[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, index
+
+
+def decode(dumps):
+    """Yields (time in us, kind, fields) for every record, times continue across dumps."""
+    cycles = 0
+    for cycles_per_second, dropped, data in dumps:
+        if dropped:
+            print(f"warning: {dropped} records were lost before this dump", file=sys.stderr)
+        index = 0
+        while index < len(data):
+            header = data[index]
+            delta, index = read_varint(data, index + 1)
+            cycles += delta
+            time = cycles * 1_000_000 // cycles_per_second
+            kind = header & ((1 << KIND_BITS) - 1)
+
+            if kind == EVENT:
+                code, index = read_varint(data, index)
+                zigzag, index = read_varint(data, index)
+                value = (zigzag >> 1) ^ -(zigzag & 1)
+                yield time, EVENT, (header >> 4, code, value, (header >> 3) & 1)
+            elif kind == DECISION:
+                yield time, DECISION, header >> KIND_BITS
+            else:
+                yield time, REPORT, None
+
+
+def percentile(values, percent):
+    return values[min(len(values) - 1, len(values) * percent // 100)]
+
+
+def print_latencies(records):
+    """Every report is attributed to the events since the previous report."""
+    newest, oldest = [], []
+    pending = []
+    decisions = [0] * len(DECISIONS)
+    for time, kind, fields in records:
+        if kind == EVENT:
+            pending.append(time)
+        elif kind == DECISION and fields < len(DECISIONS):
+            decisions[fields] += 1
+        elif kind == REPORT and pending:
+            newest.append(time - pending[-1])
+            oldest.append(time - pending[0])
+            pending = []
+
+    if not newest:
+        sys.exit("no reports that follow an event in the trace")
+
+    for name, values in (("newest event", newest), ("oldest event", oldest)):
+        values.sort()
+        print(f"{name} to report [us]: min {values[0]}, median {percentile(values, 50)}, "
+              f"p95 {percentile(values, 95)}, max {values[-1]}, {len(values)} reports")
+    print("decisions: " + ", ".join(f"{name} {count}" for name, count in zip(DECISIONS, decisions)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    output = parser.add_mutually_exclusive_group()
+    output.add_argument("--records", action="store_true", help="print every record")
+    output.add_argument("--replay", action="store_true", help="print the events as trace lines for trace_to_dtsi.py")
+    args = parser.parse_args()
+
+    dumps = list(read_dumps(args.log))
+    if not dumps:
+        sys.exit("no latency trace found - was CONFIG_INPUT_GESTURES_LATENCY_TRACE enabled and dumped?")
+    records = decode(dumps)
+
+    if args.records:
+        for time, kind, fields in records:
+            if kind == EVENT:
+                print(f"{time} event {' '.join(str(field) for field in fields)}")
+            elif kind == DECISION:
+                print(f"{time} decision {DECISIONS[fields] if fields < len(DECISIONS) else fields}")
+            else:
+                print(f"{time} report")
+    elif args.replay:
+        for time, kind, fields in records:
+            if kind == EVENT:
+                type_, code, value, sync = fields
+                print(f"trace: {time // 1000} {type_} {code} {value} {sync}")
+    else:
+        print_latencies(records)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+"""
+Converts a log recorded with CONFIG_INPUT_GESTURES_TRACE_RECORD=y into a devicetree
+snippet that sets the events of a zmk,input-gestures-trace-replay node.
+
+    scripts/trace_to_dtsi.py usb-log.txt > my_trace.dtsi
+"""
+
+import argparse
+import re
+import sys
+
+TRACE_LINE = re.compile(r"trace: (\d+) (\d+) (\d+) (-?\d+) (\d+)")
+
+
+def read_events(lines):
+    for line in lines:
+        match = TRACE_LINE.search(line)
+        if match:
+            yield tuple(int(cell) for cell in match.groups())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    parser.add_argument("--label", default="trace_replay", help="node label of the replay node")
+    args = parser.parse_args()
+
+    events = list(read_events(args.log))
+    if not events:
+        sys.exit("no trace lines found - was CONFIG_INPUT_GESTURES_TRACE_RECORD enabled?")
+
+    first = events[0][0]
+    print(f"/* generated by scripts/trace_to_dtsi.py: {len(events)} events */")
+    print(f"&{args.label} {{")
+    print("    events = <")
+    for time, type_, code, value, sync in events:
+        print(f"        {time - first} {type_} {code} {value} {sync}")
+    print("    >;")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "input_processor_gestures.h"
+#include "acceleration.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+#define CURVE_SPEED(curve, point) ((curve)[2 * (point)])
+#define CURVE_GAIN(curve, point) ((curve)[2 * (point) + 1])
+
+// Touchpads send positions far more often than this, slower frames count as this long
+#define MAX_FRAME_MS 63
+
+// 1 / ms for every frame length, so that a speed doesn't take a division
+#define RECIPROCAL_MS(ms, ...) (FIX16_ONE / MAX(ms, 1))
+static const fix16_t reciprocal_ms[MAX_FRAME_MS + 1] = {LISTIFY(MAX_FRAME_MS + 1, RECIPROCAL_MS, (,))};
+
+// Gain of the curve in percent at speed in pixels per second, linear between its points and
+// constant beyond its ends
+static int32_t curve_gain_percent(const int32_t *curve, uint8_t points, int32_t speed) {
+    if (speed <= CURVE_SPEED(curve, 0)) {
+        return CURVE_GAIN(curve, 0);
+    }
+
+    for (uint8_t i = 1; i < points; i++) {
+        int32_t speed_1 = CURVE_SPEED(curve, i - 1), speed_2 = CURVE_SPEED(curve, i);
+        if (speed <= speed_2) {
+            int32_t gain_1 = CURVE_GAIN(curve, i - 1), gain_2 = CURVE_GAIN(curve, i);
+            return gain_1 + (int64_t)(gain_2 - gain_1) * (speed - speed_1) / MAX(speed_2 - speed_1, 1);
+        }
+    }
+
+    return CURVE_GAIN(curve, points - 1);
+}
+
+void acceleration_init(const struct device *dev) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    const int32_t *curve = config->acceleration.curve;
+    uint8_t points = config->acceleration.curve_len / 2;
+
+    if (points == 0) {
+        return;
+    }
+
+    int32_t max_speed = CURVE_SPEED(curve, points - 1);
+
+    // the speeds of the table are in pixels per second, the lookups in pixels per ms
+    data->acceleration.entries_per_speed =
+        max_speed > 0 ? (fix16_t)(((int64_t)(ACCELERATION_LUT_SIZE - 1) * 1000 << FIX16_SHIFT) / max_speed) : 0;
+
+    for (int i = 0; i < ACCELERATION_LUT_SIZE; i++) {
+        int32_t speed = max_speed * i / (ACCELERATION_LUT_SIZE - 1);
+        data->acceleration.gain[i] = fix16_from_percent(curve_gain_percent(curve, points, speed));
+    }
+
+    LOG_DBG("acceleration: %u points up to %d px/s, gain %d%% to %d%%", points, max_speed,
+            CURVE_GAIN(curve, 0), CURVE_GAIN(curve, points - 1));
+}
+
+// The gain at a position in the table, in entries
+static fix16_t acceleration_lookup(const fix16_t *gain, int64_t position) {
+    if (position >= fix16_from_int(ACCELERATION_LUT_SIZE - 1)) {
+        return gain[ACCELERATION_LUT_SIZE - 1];
+    }
+
+    int32_t index = fix16_to_int((fix16_t)position);
+    return gain[index] + fix16_mul(gain[index + 1] - gain[index], (fix16_t)position & (FIX16_ONE - 1));
+}
+
+fix16_t acceleration_gain(const struct device *dev, fix16_t speed) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    if (config->acceleration.curve_len == 0) {
+        return FIX16_ONE;
+    }
+
+    return acceleration_lookup(data->acceleration.gain,
+                               ((int64_t)abs(speed) * data->acceleration.entries_per_speed) >> FIX16_SHIFT);
+}
+
+// Length of the movement in 1/8 pixels, approximated by an octagon: max + 3/8 min is between 3%
+// too short and 7% too long, which the curve doesn't notice
+static uint32_t octagonal_length(int32_t dx, int32_t dy) {
+    uint32_t x = MIN(abs(dx), UINT16_MAX), y = MIN(abs(dy), UINT16_MAX);
+    return 8 * MAX(x, y) + 3 * MIN(x, y);
+}
+
+void acceleration_event(const struct device *dev, struct input_event *event, uint32_t timestamp) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    struct acceleration_data *acceleration = &data->acceleration;
+    bool absolute = event->type == INPUT_EV_ABS;
+    enum acceleration_axis axis;
+
+    if (config->acceleration.curve_len == 0) {
+        return;
+    }
+
+    if ((absolute && event->code == INPUT_ABS_X) || (event->type == INPUT_EV_REL && event->code == INPUT_REL_X)) {
+        axis = ACCELERATION_AXIS_X;
+    } else if ((absolute && event->code == INPUT_ABS_Y) ||
+               (event->type == INPUT_EV_REL && event->code == INPUT_REL_Y)) {
+        axis = ACCELERATION_AXIS_Y;
+    } else {
+        return;
+    }
+
+    enum acceleration_axis other = axis == ACCELERATION_AXIS_X ? ACCELERATION_AXIS_Y : ACCELERATION_AXIS_X;
+    uint32_t new_touch_ms = config->touch_detection.wait_for_new_position_ms;
+    uint32_t dt = timestamp - acceleration->timestamp[axis];
+    bool is_new_touch = dt > new_touch_ms;
+    int32_t delta = event->value;
+
+    acceleration->timestamp[axis] = timestamp;
+
+    if (is_new_touch) {
+        acceleration->remainder[axis] = 0;
+    }
+
+    if (absolute) {
+        if (is_new_touch) {
+            // a new touch starts wherever the finger is
+            acceleration->raw[axis] = event->value;
+            acceleration->position[axis] = event->value;
+            acceleration->delta[axis] = 0;
+            return;
+        }
+        delta = event->value - acceleration->raw[axis];
+        acceleration->raw[axis] = event->value;
+    }
+
+    dt = CLAMP(dt, 1, MAX(new_touch_ms, 1));
+
+    // the other axis of the same frame arrived just before, or didn't move at all
+    int32_t other_delta = timestamp - acceleration->timestamp[other] <= dt ? acceleration->delta[other] : 0;
+    acceleration->delta[axis] = delta;
+
+    // the speed in pixels per ms, scaled right away into a position in the table
+    fix16_t entries_per_pixel = fix16_mul(acceleration->entries_per_speed, reciprocal_ms[MIN(dt, MAX_FRAME_MS)]);
+    int64_t position = ((int64_t)octagonal_length(delta, other_delta) * entries_per_pixel) >> 3;
+    fix16_t gain = acceleration_lookup(acceleration->gain, position);
+
+    fix16_t moved = fix16_mul(fix16_from_int(delta), gain) + acceleration->remainder[axis];
+    int32_t pixels = fix16_to_int(moved);
+    acceleration->remainder[axis] = moved - fix16_from_int(pixels);
+
+    if (absolute) {
+        // the input processors after the gestures only see the accelerated position, which stays
+        // on the touchpad like the finger
+        int32_t size = axis == ACCELERATION_AXIS_X ? config->acceleration.width : config->acceleration.height;
+        acceleration->position[axis] = CLAMP(acceleration->position[axis] + pixels, 0, MAX(size - 1, 0));
+        event->value = acceleration->position[axis];
+    } else {
+        event->value = pixels;
+    }
+}
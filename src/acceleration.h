@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+#include "gesture_math.h"
+
+// The curve from devicetree is sampled into this many gains, evenly spaced from 0 up to the speed
+// of its last point
+#define ACCELERATION_LUT_SIZE 32
+
+enum acceleration_axis {
+    ACCELERATION_AXIS_X,
+    ACCELERATION_AXIS_Y,
+    ACCELERATION_AXIS_COUNT,
+};
+
+struct acceleration_data {
+    fix16_t gain[ACCELERATION_LUT_SIZE];
+    // turns a speed in pixels per ms into a position in gain
+    fix16_t entries_per_speed;
+    // the last movement of each axis and when it was reported
+    int32_t delta[ACCELERATION_AXIS_COUNT];
+    uint32_t timestamp[ACCELERATION_AXIS_COUNT];
+    // in absolute mode, the raw position and the accelerated one that is reported instead
+    int32_t raw[ACCELERATION_AXIS_COUNT];
+    int32_t position[ACCELERATION_AXIS_COUNT];
+    // fractions of pixels that haven't been reported yet
+    fix16_t remainder[ACCELERATION_AXIS_COUNT];
+};
+
+struct acceleration_config {
+    // pairs of <speed in pixels per second, gain in percent>, sorted by speed. Empty without
+    // acceleration.
+    const int32_t *curve;
+    const uint8_t curve_len;
+    // in absolute mode, the accelerated position stays within the touchpad
+    const uint16_t width, height;
+};
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_ACCELERATION)
+
+void acceleration_init(const struct device *dev);
+
+// The gain for a speed in pixels per ms, 1.0 without acceleration
+fix16_t acceleration_gain(const struct device *dev, fix16_t speed);
+
+// Accelerates the movement of a REL_X/REL_Y or ABS_X/ABS_Y event for the input processors after
+// the gestures. The gestures themselves see the position of the finger.
+void acceleration_event(const struct device *dev, struct input_event *event, uint32_t timestamp);
+
+#else
+
+static inline void acceleration_init(const struct device *dev) {}
+static inline fix16_t acceleration_gain(const struct device *dev, fix16_t speed) { return FIX16_ONE; }
+static inline void acceleration_event(const struct device *dev, struct input_event *event, uint32_t timestamp) {}
+
+#endif
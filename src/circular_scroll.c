@@ -1,114 +1,126 @@
 #include <drivers/input_processor.h>
 #include <zephyr/logging/log.h>
-#include <math.h>
 
 #include "input_processor_gestures.h"
 #include "circular_scroll.h"
-
-#define PI 3.14159265358979323846f
+#include "gesture_math.h"
 
 LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
 
-static bool is_touch_on_perimeter(struct gesture_event_t *event, struct gesture_config *config, struct gesture_data *data) {
-    uint32_t squared_distance = (event->x - data->circular_scroll.half_width) * (event->x - data->circular_scroll.half_width) + 
-                                (event->y - data->circular_scroll.half_width) * (event->y - data->circular_scroll.half_width);
-    return (squared_distance >= data->circular_scroll.inner_radius_squared && 
-            squared_distance <= data->circular_scroll.outer_radius_squared);
+static fix16_t calculate_angle(struct gesture_event_t *event, struct gesture_config *config, struct gesture_data *data) {
+    return fix16_atan2_deg(event->x - data->zones.half_width, event->y - data->zones.half_height);
 }
 
-static uint16_t calculate_angle(struct gesture_event_t *event, struct gesture_config *config, struct gesture_data *data) {
-    float angleRadians = atan2f(event->x - data->circular_scroll.half_width, event->y - data->circular_scroll.half_height);
-    float angleDegrees = angleRadians * (180.0f / PI);
-    if (angleDegrees < 0) {
-        angleDegrees += 360.0f;
+static fix16_t normalizeAngleDifference(fix16_t angle1, fix16_t angle2) {
+    fix16_t difference = angle2 - angle1;
+    if (difference > fix16_from_int(180)) {
+        difference -= fix16_from_int(360);
+    } else if (difference <= fix16_from_int(-180)) {
+        difference += fix16_from_int(360);
     }
-    return (uint16_t)angleDegrees;
+    return difference;
 }
 
-static float normalizeAngleDifference(uint16_t angle1, uint16_t angle2) {
-    float difference = (float)angle2 - (float)angle1;
-    while (difference > 180.0f) {
-        difference -= 360.0f;
-    }
-    while (difference < -180.0f) {
-        difference += 360.0f;
+// Rotation in ticks per ms at the end of the touch, from how far its velocity would turn the last position
+static fix16_t calculate_ticks_per_ms(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    fix16_t velocity_x, velocity_y;
+
+    if (touch_detection_velocity(dev, KINETIC_SCROLL_VELOCITY_WINDOW_MS, &velocity_x, &velocity_y) < 0) {
+        return 0;
     }
-    return difference;
+
+    // in 1/16 pixels, since the angle doesn't depend on the scale, and 16 ms ahead, so that the
+    // rotation is well above the error of the angles
+    int32_t x = (data->touch_detection.x - data->zones.half_width) * 16;
+    int32_t y = (data->touch_detection.y - data->zones.half_height) * 16;
+    fix16_t angle = fix16_atan2_deg(x, y);
+    fix16_t next_angle = fix16_atan2_deg(x + velocity_x / (FIX16_ONE / 256), y + velocity_y / (FIX16_ONE / 256));
+
+    return normalizeAngleDifference(next_angle, angle) / 16 / config->circular_scroll.degrees_per_tick;
 }
 
-int circular_scroll_handle_start(const struct device *dev, struct gesture_event_t *event) {
+static int circular_scroll_handle_start(const struct device *dev, struct gesture_event_t *event) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
     struct gesture_config *config = (struct gesture_config *)dev->config;
-    if (!config->circular_scroll.enabled || !event->absolute) {
+    kinetic_scroll_stop(dev);
+    if (!event->absolute) {
         return -1;
     }
 
-    if (is_touch_on_perimeter(event, config, data)) {
+    if (touch_zones_classify(&data->zones, event->x, event->y) & BIT(TOUCH_ZONE_RIM)) {
         data->circular_scroll.is_tracking = true;
+        atomic_set_bit(&data->raw_event_claims, GESTURE_CLAIM_CIRCULAR_SCROLL);
+        trace_replay_note_decision(TRACE_REPLAY_CIRCULAR_SCROLL);
         data->circular_scroll.previous_angle = calculate_angle(event, config, data);
-        LOG_DBG("starting circular scrolling with angle %d!", data->circular_scroll.previous_angle);
+        scroll_accumulator_reset(&data->circular_scroll.scroll);
+        LOG_DBG("starting circular scrolling with angle %d!", fix16_to_int(data->circular_scroll.previous_angle));
     }
 
     return 0;
 }
 
-int circular_scroll_handle_touch(const struct device *dev, struct gesture_event_t *event) {
+static int circular_scroll_handle_touch(const struct device *dev, struct gesture_event_t *event) {
     struct gesture_config *config = (struct gesture_config *)dev->config;
     struct gesture_data *data = (struct gesture_data *)dev->data;
 
-    if (!config->circular_scroll.enabled || 
-        !data->circular_scroll.is_tracking) {
+    if (!data->circular_scroll.is_tracking) {
         return -1;
     }
 
     if (event->absolute) {
-        uint16_t current_angle = calculate_angle(event, config, data);
-        event->raw_event_1->code = 0;
-        event->raw_event_1->type = 0;
-        event->raw_event_1->value = 0;
+        fix16_t current_angle = calculate_angle(event, config, data);
+        fix16_t rotation = normalizeAngleDifference(current_angle, data->circular_scroll.previous_angle);
+        data->circular_scroll.previous_angle = current_angle;
 
-        event->raw_event_2->code = INPUT_REL_WHEEL;
-        event->raw_event_2->type = INPUT_EV_REL;
-        event->raw_event_2->value = normalizeAngleDifference(current_angle, data->circular_scroll.previous_angle);
+        fix16_t ticks = rotation / config->circular_scroll.degrees_per_tick;
+        if (!gestures_scroll(dev, event, &data->circular_scroll.scroll, INPUT_REL_WHEEL, ticks)) {
+            return 0;
+        }
 
-        data->circular_scroll.previous_angle = current_angle;
+        // scrolling has begun, so this touch is neither a tap nor a fling
+        return GESTURE_CLAIM;
     }
 
     return 0;
 }
 
-int circular_scroll_handle_end(const struct device *dev) {
+static int circular_scroll_handle_cancel(const struct device *dev) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
 
     if (data->circular_scroll.is_tracking) {
         data->circular_scroll.is_tracking = false;
+        atomic_clear_bit(&data->raw_event_claims, GESTURE_CLAIM_CIRCULAR_SCROLL);
     }
 
     return 0;
 }
 
-int circular_scroll_init(const struct device *dev) {
-    struct gesture_config *config = (struct gesture_config *)dev->config;
+static int circular_scroll_handle_end(const struct device *dev) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
-    LOG_DBG("circular_scroll: %s, rim_percent: %d, width: %d, height: %d", 
-        config->circular_scroll.enabled ? "yes" : "no", 
-        config->circular_scroll.circular_scroll_rim_percent,
-        config->circular_scroll.width,
-        config->circular_scroll.height);
 
-    if (!config->circular_scroll.enabled) {
-        return -1;
+    if (data->circular_scroll.is_tracking) {
+        kinetic_scroll_start(dev, 0, calculate_ticks_per_ms(dev));
     }
 
-    // Предварительный расчёт для оптимизации обработки событий касания
-    data->circular_scroll.half_width = config->circular_scroll.width / 2;
-    data->circular_scroll.half_height = config->circular_scroll.height / 2;
-
-    uint16_t threshold = (config->circular_scroll.width + config->circular_scroll.height) * (config->circular_scroll.circular_scroll_rim_percent / 2);
-    threshold /= 100;
-    uint16_t inner_radius = data->circular_scroll.half_width - threshold;
-    data->circular_scroll.inner_radius_squared = inner_radius * inner_radius;
-    data->circular_scroll.outer_radius_squared = data->circular_scroll.half_width * data->circular_scroll.half_width;
+    return circular_scroll_handle_cancel(dev);
+}
 
+static int circular_scroll_init(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    LOG_DBG("circular_scroll: degrees_per_tick: %d", config->circular_scroll.degrees_per_tick);
     return 0;
 }
+
+// Circular scroll comes first, it only claims the touch once it actually scrolls
+const struct gesture_recognizer circular_scroll_recognizer = {
+    .name = "circular scroll",
+    .priority = 30,
+    .stage = GESTURE_STATS_CIRCULAR_SCROLL,
+    .init = circular_scroll_init,
+    .touch_start = circular_scroll_handle_start,
+    .touch = circular_scroll_handle_touch,
+    .touch_end = circular_scroll_handle_end,
+    .cancel = circular_scroll_handle_cancel,
+};
@@ -7,26 +7,19 @@
 #pragma once
 
 #include "input_processor_gestures.h"
+#include "gesture_math.h"
 
 struct circular_scroll_data {
     bool is_tracking;
-    uint16_t previous_angle;
+    fix16_t previous_angle;
+    struct scroll_accumulator scroll;
     gesture_data *all;
-
-    uint16_t half_width, half_height;
-    uint32_t inner_radius_squared, outer_radius_squared;
 };
 
+// The rim itself is part of the touch zones, see touch_zones.h
 struct circular_scroll_config {
-    const bool enabled;
-    const uint16_t width, height;
-    const uint8_t circular_scroll_rim_percent;
+    const uint8_t degrees_per_tick;
 };
 
-extern volatile bool scroll_mode_active;
-
-handle_init_t circular_scroll_init;
-handle_touch_t circular_scroll_handle_start;
-handle_touch_t  circular_scroll_handle_touch;
-handle_touch_end_t circular_scroll_handle_end;
+extern const struct gesture_recognizer circular_scroll_recognizer;
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "input_processor_gestures.h"
+#include "decay_animation.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+// decay_percent is the velocity lost during this time
+#define DECAY_REFERENCE_MS 10
+
+// a late frame doesn't cover more than this, so that a stalled work queue doesn't jump
+#define MAX_FRAME_MS 255
+
+// Pixels covered with the average of both velocities, keeping the fractions for the next frame.
+// A fast hires scroll covers more than fix16_t holds in a long frame, so it saturates there.
+static int32_t decay_animation_advance(fix16_t *remainder, fix16_t velocity, fix16_t next_velocity,
+                                       uint32_t elapsed) {
+    int64_t distance = ((int64_t)velocity + next_velocity) * elapsed / 2 + *remainder;
+    distance = CLAMP(distance, -(int64_t)FIX16_MAX, (int64_t)FIX16_MAX);
+
+    int32_t pixels = fix16_to_int((fix16_t)distance);
+    *remainder = (fix16_t)distance - fix16_from_int(pixels);
+    return pixels;
+}
+
+static void decay_animation_work_handler(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct decay_animation *animation = CONTAINER_OF(d_work, struct decay_animation, work);
+    uint32_t started = gesture_stats_start();
+
+    gesture_stats_count(animation->dev, GESTURE_STATS_WAKEUPS);
+
+    uint32_t now = gestures_uptime_get();
+    uint32_t elapsed = MIN(now - animation->last_frame_timestamp, MAX_FRAME_MS);
+    animation->last_frame_timestamp = now;
+
+    // the decay depends on the time that actually passed, not on how often this runs
+    fix16_t decay = fix16_pow_int(animation->decay_per_ms, elapsed);
+    fix16_t velocity_x = fix16_mul(animation->velocity_x, decay);
+    fix16_t velocity_y = fix16_mul(animation->velocity_y, decay);
+
+    int32_t move_x = decay_animation_advance(&animation->remainder_x, animation->velocity_x, velocity_x, elapsed);
+    int32_t move_y = decay_animation_advance(&animation->remainder_y, animation->velocity_y, velocity_y, elapsed);
+    animation->velocity_x = velocity_x;
+    animation->velocity_y = velocity_y;
+
+    LOG_DBG("elapsed: %d, move_x: %d, move_y: %d", elapsed, move_x, move_y);
+
+    if (move_x != 0 || move_y != 0) {
+        animation->step(animation, move_x, move_y);
+    }
+
+    bool is_moving = abs(velocity_x) >= animation->stop_velocity || abs(velocity_y) >= animation->stop_velocity;
+    bool is_expired = now - animation->start_timestamp >= CONFIG_INPUT_GESTURES_GLIDE_MAX_MS;
+
+    if (is_moving && !is_expired) {
+        gestures_work_reschedule(&animation->work, K_MSEC(animation->frame_ms));
+    } else {
+        LOG_DBG("glide over after %d ms", now - animation->start_timestamp);
+    }
+
+    gesture_stats_stop(animation->dev, animation->stage, started);
+}
+
+void decay_animation_init(struct decay_animation *animation, const struct device *dev,
+                          enum gesture_stats_stage stage, decay_animation_step_t *step, uint8_t decay_percent,
+                          uint8_t frame_ms, fix16_t stop_velocity) {
+    animation->dev = dev;
+    animation->stage = stage;
+    animation->step = step;
+    // a frame every 0 ms would never let the CPU sleep
+    animation->frame_ms = MAX(frame_ms, 1);
+    animation->stop_velocity = stop_velocity;
+    animation->decay_per_ms = fix16_unit_root(fix16_from_percent(100 - decay_percent), DECAY_REFERENCE_MS);
+    LOG_DBG("decay_per_ms *1000: %d", fix16_to_int(animation->decay_per_ms * 1000));
+
+    k_work_init_delayable(&animation->work, decay_animation_work_handler);
+}
+
+void decay_animation_start(struct decay_animation *animation, fix16_t velocity_x, fix16_t velocity_y) {
+    animation->velocity_x = velocity_x;
+    animation->velocity_y = velocity_y;
+    animation->remainder_x = 0;
+    animation->remainder_y = 0;
+    animation->start_timestamp = gestures_uptime_get();
+    animation->last_frame_timestamp = animation->start_timestamp;
+
+    gestures_work_reschedule(&animation->work, K_MSEC(animation->frame_ms));
+}
+
+void decay_animation_stop(struct decay_animation *animation) {
+    k_work_cancel_delayable(&animation->work);
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include "gesture_math.h"
+#include "gesture_stats.h"
+
+struct decay_animation;
+
+// Called every frame with the whole units covered since the last one
+typedef void (decay_animation_step_t)(struct decay_animation *animation, int32_t x, int32_t y);
+
+// Keeps moving with a velocity that decays exponentially over time, like something sliding with
+// friction after a flick. The units are up to the user: pixels for the cursor, wheel ticks for
+// scrolling.
+struct decay_animation {
+    struct k_work_delayable work;
+    // units per ms and the fractions of units that haven't been sent yet
+    fix16_t velocity_x, velocity_y;
+    fix16_t remainder_x, remainder_y;
+    uint32_t start_timestamp, last_frame_timestamp;
+    fix16_t decay_per_ms;
+    // the animation stops once both velocities are below this, or after
+    // CONFIG_INPUT_GESTURES_GLIDE_MAX_MS
+    fix16_t stop_velocity;
+    uint8_t frame_ms;
+    enum gesture_stats_stage stage;
+    const struct device *dev;
+    decay_animation_step_t *step;
+};
+
+// decay_percent is the velocity lost every 10 ms. The decay depends on the time that actually
+// passed, frame_ms only changes how smooth it looks.
+void decay_animation_init(struct decay_animation *animation, const struct device *dev,
+                          enum gesture_stats_stage stage, decay_animation_step_t *step, uint8_t decay_percent,
+                          uint8_t frame_ms, fix16_t stop_velocity);
+
+void decay_animation_start(struct decay_animation *animation, fix16_t velocity_x, fix16_t velocity_y);
+
+void decay_animation_stop(struct decay_animation *animation);
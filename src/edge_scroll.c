@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <drivers/input_processor.h>
+#include <zephyr/logging/log.h>
+
+#include "input_processor_gestures.h"
+#include "edge_scroll.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+static int edge_scroll_handle_start(const struct device *dev, struct gesture_event_t *event) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    kinetic_scroll_stop(dev);
+    if (!event->absolute) {
+        return -1;
+    }
+
+    uint8_t zones = touch_zones_classify(&data->zones, event->x, event->y);
+
+    // where an edge overlaps the rim, circular scroll wins
+    if (zones & BIT(TOUCH_ZONE_RIM)) {
+        return 0;
+    }
+
+    switch (zones & (BIT(TOUCH_ZONE_RIGHT) | BIT(TOUCH_ZONE_TOP))) {
+    case BIT(TOUCH_ZONE_RIGHT):
+        data->edge_scroll.mode = EDGE_SCROLL_VERTICAL;
+        break;
+    case BIT(TOUCH_ZONE_TOP):
+        data->edge_scroll.mode = EDGE_SCROLL_HORIZONTAL;
+        break;
+    case BIT(TOUCH_ZONE_RIGHT) | BIT(TOUCH_ZONE_TOP):
+        data->edge_scroll.mode = EDGE_SCROLL_CORNER;
+        break;
+    default:
+        return 0;
+    }
+
+    trace_replay_note_decision(TRACE_REPLAY_EDGE_SCROLL);
+    scroll_accumulator_reset(&data->edge_scroll.scroll);
+    LOG_DBG("starting edge scrolling in mode %d", data->edge_scroll.mode);
+
+    return 0;
+}
+
+static int edge_scroll_handle_touch(const struct device *dev, struct gesture_event_t *event) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    if (data->edge_scroll.mode == EDGE_SCROLL_NONE) {
+        return -1;
+    }
+
+    if (!event->absolute) {
+        return 0;
+    }
+
+    int32_t delta_x = GESTURES_REPORT_X(event->delta_x, event->delta_y);
+    int32_t delta_y = GESTURES_REPORT_Y(event->delta_x, event->delta_y);
+
+    if (data->edge_scroll.mode == EDGE_SCROLL_CORNER) {
+        if (delta_x == 0 && delta_y == 0) {
+            return 0;
+        }
+        data->edge_scroll.mode = abs(delta_y) >= abs(delta_x) ? EDGE_SCROLL_VERTICAL : EDGE_SCROLL_HORIZONTAL;
+    }
+
+    // moving up or right scrolls up or right
+    uint16_t code;
+    int32_t movement;
+    if (data->edge_scroll.mode == EDGE_SCROLL_VERTICAL) {
+        movement = -delta_y;
+        code = INPUT_REL_WHEEL;
+    } else {
+        movement = delta_x;
+        code = INPUT_REL_HWHEEL;
+    }
+
+    fix16_t ticks = fix16_from_int(movement) / config->edge_scroll.pixels_per_tick;
+    if (!gestures_scroll(dev, event, &data->edge_scroll.scroll, code, ticks)) {
+        return 0;
+    }
+
+    // until the first tick, a touch that leaves the side inwards still moves the cursor
+    atomic_set_bit(&data->raw_event_claims, GESTURE_CLAIM_EDGE_SCROLL);
+    return GESTURE_CLAIM;
+}
+
+static int edge_scroll_handle_cancel(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    if (data->edge_scroll.mode != EDGE_SCROLL_NONE) {
+        data->edge_scroll.mode = EDGE_SCROLL_NONE;
+        atomic_clear_bit(&data->raw_event_claims, GESTURE_CLAIM_EDGE_SCROLL);
+    }
+
+    return 0;
+}
+
+static int edge_scroll_handle_end(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    enum edge_scroll_mode mode = data->edge_scroll.mode;
+    fix16_t velocity_x, velocity_y;
+
+    if ((mode == EDGE_SCROLL_VERTICAL || mode == EDGE_SCROLL_HORIZONTAL) &&
+        touch_detection_velocity(dev, KINETIC_SCROLL_VELOCITY_WINDOW_MS, &velocity_x, &velocity_y) == 0) {
+        int32_t pixels_per_tick = config->edge_scroll.pixels_per_tick;
+        if (mode == EDGE_SCROLL_VERTICAL) {
+            kinetic_scroll_start(dev, 0, -GESTURES_REPORT_Y(velocity_x, velocity_y) / pixels_per_tick);
+        } else {
+            kinetic_scroll_start(dev, GESTURES_REPORT_X(velocity_x, velocity_y) / pixels_per_tick, 0);
+        }
+    }
+
+    return edge_scroll_handle_cancel(dev);
+}
+
+static int edge_scroll_init(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    LOG_DBG("edge_scroll: pixels_per_tick: %d", config->edge_scroll.pixels_per_tick);
+    return 0;
+}
+
+// Right after circular scroll, like it, it only claims the touch once it actually scrolls
+const struct gesture_recognizer edge_scroll_recognizer = {
+    .name = "edge scroll",
+    .priority = 25,
+    .stage = GESTURE_STATS_EDGE_SCROLL,
+    .init = edge_scroll_init,
+    .touch_start = edge_scroll_handle_start,
+    .touch = edge_scroll_handle_touch,
+    .touch_end = edge_scroll_handle_end,
+    .cancel = edge_scroll_handle_cancel,
+};
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "input_processor_gestures.h"
+
+enum edge_scroll_mode {
+    EDGE_SCROLL_NONE,
+    EDGE_SCROLL_VERTICAL,
+    EDGE_SCROLL_HORIZONTAL,
+    // started in the top right corner, the first movement decides the direction
+    EDGE_SCROLL_CORNER,
+};
+
+struct edge_scroll_data {
+    enum edge_scroll_mode mode;
+    struct scroll_accumulator scroll;
+    gesture_data *all;
+};
+
+// The edges themselves are part of the touch zones, see touch_zones.h
+struct edge_scroll_config {
+    const uint16_t pixels_per_tick;
+};
+
+extern const struct gesture_recognizer edge_scroll_recognizer;
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include "gesture_math.h"
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MATH_FLOAT)
+
+#include <math.h>
+
+#define PI 3.14159265358979323846f
+
+fix16_t fix16_hypot(int32_t dx, int32_t dy) {
+    float length = sqrtf((float)dx * dx + (float)dy * dy);
+    if (length >= (float)(FIX16_MAX >> FIX16_SHIFT)) {
+        return FIX16_MAX;
+    }
+    return (fix16_t)(length * FIX16_ONE);
+}
+
+fix16_t fix16_length(fix16_t x, fix16_t y) {
+    float fx = (float)x / FIX16_ONE;
+    float fy = (float)y / FIX16_ONE;
+    return (fix16_t)(sqrtf(fx * fx + fy * fy) * FIX16_ONE);
+}
+
+fix16_t fix16_atan2_deg(int32_t y, int32_t x) {
+    return (fix16_t)(atan2f(y, x) * (180.0f / PI) * FIX16_ONE);
+}
+
+#else
+
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
+
+fix16_t fix16_hypot(int32_t dx, int32_t dy) {
+    uint64_t squared = (uint64_t)((int64_t)dx * dx) + (uint64_t)((int64_t)dy * dy);
+
+    if (squared <= UINT32_MAX) {
+        // sqrt(squared << 32) == sqrt(squared) << 16, with all fractional bits intact, but from a
+        // length of 32768 on that doesn't fit into fix16_t anymore
+        return (fix16_t)MIN(isqrt64(squared << 32), (uint32_t)FIX16_MAX);
+    }
+
+    uint32_t length = isqrt64(squared);
+    if (length > (FIX16_MAX >> FIX16_SHIFT)) {
+        return FIX16_MAX;
+    }
+    return fix16_from_int(length);
+}
+
+fix16_t fix16_length(fix16_t x, fix16_t y) {
+    // the squares are Q32.32, so their square root is Q16.16 again
+    uint64_t squared = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y);
+    return (fix16_t)MIN(isqrt64(squared), (uint32_t)FIX16_MAX);
+}
+
+// atan(2^-i) in degrees
+static const fix16_t cordic_angles[] = {
+    2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+    14668,   7334,    3667,   1833,   917,    458,    229,    115,
+};
+
+BUILD_ASSERT(CONFIG_INPUT_GESTURES_CORDIC_ITERATIONS <= ARRAY_SIZE(cordic_angles),
+             "not enough precalculated CORDIC angles");
+
+// CORDIC in vectoring mode: rotates (x, y) onto the x axis in steps of atan(2^-i) and sums up
+// the steps. Only needs shifts and additions, no multiplication or division.
+fix16_t fix16_atan2_deg(int32_t y, int32_t x) {
+    fix16_t angle = 0;
+
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+
+    // scale into 24 bit for precision: the vector grows by ~1.65 during the rotations
+    while (x > (1 << 23) || x < -(1 << 23) || y > (1 << 23) || y < -(1 << 23)) {
+        x >>= 1;
+        y >>= 1;
+    }
+    while (x < (1 << 22) && x > -(1 << 22) && y < (1 << 22) && y > -(1 << 22)) {
+        x <<= 1;
+        y <<= 1;
+    }
+
+    // rotate into the right half plane first, CORDIC only converges within +-99 degrees
+    if (x < 0) {
+        int32_t previous_x = x;
+        if (y >= 0) {
+            x = y;
+            y = -previous_x;
+            angle = fix16_from_int(90);
+        } else {
+            x = -y;
+            y = previous_x;
+            angle = fix16_from_int(-90);
+        }
+    }
+
+    for (int i = 0; i < CONFIG_INPUT_GESTURES_CORDIC_ITERATIONS; i++) {
+        int32_t previous_x = x;
+        if (y > 0) {
+            x += y >> i;
+            y -= previous_x >> i;
+            angle += cordic_angles[i];
+        } else {
+            x -= y >> i;
+            y += previous_x >> i;
+            angle -= cordic_angles[i];
+        }
+    }
+
+    if (angle > fix16_from_int(180)) {
+        angle -= fix16_from_int(360);
+    } else if (angle <= fix16_from_int(-180)) {
+        angle += fix16_from_int(360);
+    }
+    return angle;
+}
+
+#endif
+
+fix16_t fix16_pow_int(fix16_t base, uint32_t exponent) {
+    fix16_t result = FIX16_ONE;
+
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = fix16_mul(result, base);
+        }
+        base = fix16_mul(base, base);
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+fix16_t fix16_unit_root(fix16_t value, uint32_t n) {
+    fix16_t low = 0;
+    fix16_t high = FIX16_ONE;
+
+    if (value <= 0) {
+        return 0;
+    }
+
+    while (high - low > 1) {
+        fix16_t middle = low + (high - low) / 2;
+        if (fix16_pow_int(middle, n) > value) {
+            high = middle;
+        } else {
+            low = middle;
+        }
+    }
+
+    return fix16_pow_int(high, n) <= value ? high : low;
+}
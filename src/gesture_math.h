@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Q16.16 fixed point numbers are used for all fractional state of the gestures,
+// so that FPU-less parts like the RP2040 (Cortex-M0+) don't need soft-float
+// emulation and libm on the input path.
+//
+// With CONFIG_INPUT_GESTURES_MATH_FLOAT the non-trivial functions below are
+// implemented with libm instead. The fixed point versions match them within:
+// - fix16_hypot: exact up to rounding down to the next 1/65536
+// - fix16_atan2_deg: about atan(2^-(n-1)) degrees with n = CONFIG_INPUT_GESTURES_CORDIC_ITERATIONS
+typedef int32_t fix16_t;
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE ((fix16_t)1 << FIX16_SHIFT)
+#define FIX16_MAX INT32_MAX
+
+static inline fix16_t fix16_from_int(int32_t value) { return (fix16_t)(value * FIX16_ONE); }
+
+// Truncates towards zero, just like casting a float to int does.
+static inline int32_t fix16_to_int(fix16_t value) {
+    return value < 0 ? -(-value >> FIX16_SHIFT) : value >> FIX16_SHIFT;
+}
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    return (fix16_t)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+static inline fix16_t fix16_div(fix16_t a, fix16_t b) {
+    return (fix16_t)(((int64_t)a * FIX16_ONE) / b);
+}
+
+// percent in [0, 100] -> [0.0, 1.0]
+static inline fix16_t fix16_from_percent(int32_t percent) { return percent * FIX16_ONE / 100; }
+
+// base^exponent
+fix16_t fix16_pow_int(fix16_t base, uint32_t exponent);
+
+// The factor in [0, 1] that, multiplied n times with itself, results in value in [0, 1].
+// Meant for precalculations, since it takes a bisection.
+fix16_t fix16_unit_root(fix16_t value, uint32_t n);
+
+// Length of the vector (dx, dy), saturating at FIX16_MAX.
+fix16_t fix16_hypot(int32_t dx, int32_t dy);
+
+// Length of the vector (x, y) of fixed point numbers.
+fix16_t fix16_length(fix16_t x, fix16_t y);
+
+// Angle of the vector (x, y) in degrees, in the interval (-180, 180].
+fix16_t fix16_atan2_deg(int32_t y, int32_t x);
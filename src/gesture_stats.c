@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_processor_gestures
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include "input_processor_gestures.h"
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+#define GESTURE_STATS_LINE_LENGTH 200
+
+#define GESTURES_DEVICE(n) DEVICE_DT_INST_GET(n),
+static const struct device *const gestures_devices[] __maybe_unused = {DT_INST_FOREACH_STATUS_OKAY(GESTURES_DEVICE)};
+
+static const char *const counter_names[GESTURE_STATS_COUNTER_COUNT] = {
+    [GESTURE_STATS_EVENTS] = "events",
+    [GESTURE_STATS_HALF_EVENTS] = "half events",
+    [GESTURE_STATS_RING_OVERFLOWS] = "ring overflows",
+    [GESTURE_STATS_TOUCHES] = "touches",
+    [GESTURE_STATS_TOUCH_END_TIMERS] = "touch end timers",
+    [GESTURE_STATS_REPORTS] = "reports",
+    [GESTURE_STATS_WAKEUPS] = "wakeups",
+};
+
+static const char *const stage_names[GESTURE_STATS_STAGE_COUNT] = {
+    [GESTURE_STATS_INPUT] = "input",
+    [GESTURE_STATS_TAP_DETECTION] = "tap detection",
+    [GESTURE_STATS_CIRCULAR_SCROLL] = "circular scroll",
+    [GESTURE_STATS_INERTIAL_CURSOR] = "inertial cursor",
+    [GESTURE_STATS_EDGE_SCROLL] = "edge scroll",
+    [GESTURE_STATS_TWO_FINGER_SCROLL] = "two finger scroll",
+    [GESTURE_STATS_PINCH_ZOOM] = "pinch zoom",
+    [GESTURE_STATS_KINETIC_SCROLL] = "kinetic scroll",
+    [GESTURE_STATS_REPORT] = "report",
+};
+
+void gesture_stats_stop(const struct device *dev, enum gesture_stats_stage stage, uint32_t start) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    struct gesture_stats_stage_data *stage_data = &data->stats.stages[stage];
+    uint32_t cycles = k_cycle_get_32() - start;
+    uint32_t bucket = cycles == 0 ? 0 : MIN(32 - __builtin_clz(cycles), GESTURE_STATS_BUCKETS - 1);
+
+    atomic_inc(&stage_data->histogram[bucket]);
+
+    atomic_val_t max = atomic_get(&stage_data->max);
+    while ((uint32_t)max < cycles && !atomic_cas(&stage_data->max, max, cycles)) {
+        max = atomic_get(&stage_data->max);
+    }
+}
+
+#if CONFIG_INPUT_GESTURES_STATS_LOG_INTERVAL_S > 0
+static void gesture_stats_log_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(gesture_stats_log_work, gesture_stats_log_work_handler);
+#endif
+
+void gesture_stats_count(const struct device *dev, enum gesture_stats_counter counter) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    atomic_inc(&data->stats.counters[counter]);
+
+#if CONFIG_INPUT_GESTURES_STATS_LOG_INTERVAL_S > 0
+    // the stats only change while the touchpad is used, so a touch arms the log and at rest it
+    // doesn't wake anything up
+    if (counter == GESTURE_STATS_TOUCHES) {
+        gestures_work_schedule(&gesture_stats_log_work, K_SECONDS(CONFIG_INPUT_GESTURES_STATS_LOG_INTERVAL_S));
+    }
+#endif
+}
+
+// Timers and animation frames of dev that are waiting to run, 0 once the gestures are idle
+static __maybe_unused int armed_timers(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    int armed = k_work_delayable_is_pending(&data->touch_detection.touch_end_timeout_work) +
+                k_work_delayable_is_pending(&data->report_scheduler.flush_work);
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR)
+    armed += k_work_delayable_is_pending(&data->inertial_cursor.animation.work);
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL)
+    armed += k_work_delayable_is_pending(&data->kinetic_scroll.animation.work);
+#endif
+    return armed;
+}
+
+typedef void (gesture_stats_print_t)(void *context, const char *line);
+
+// Prints one line with the counters and one line per stage that ran at least once
+static __maybe_unused void gesture_stats_dump(const struct device *dev, gesture_stats_print_t *print, void *context) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    char line[GESTURE_STATS_LINE_LENGTH];
+    int length = snprintk(line, sizeof(line), "%s:", dev->name);
+
+    for (int i = 0; i < GESTURE_STATS_COUNTER_COUNT && length < sizeof(line); i++) {
+        length += snprintk(line + length, sizeof(line) - length, " %s %ld,", counter_names[i],
+                           atomic_get(&data->stats.counters[i]));
+    }
+    if (length < sizeof(line)) {
+        snprintk(line + length, sizeof(line) - length, " armed timers %d", armed_timers(dev));
+    }
+    print(context, line);
+
+    for (int stage = 0; stage < GESTURE_STATS_STAGE_COUNT; stage++) {
+        const struct gesture_stats_stage_data *stage_data = &data->stats.stages[stage];
+        uint32_t runs = 0;
+
+        for (int i = 0; i < GESTURE_STATS_BUCKETS; i++) {
+            runs += atomic_get(&stage_data->histogram[i]);
+        }
+        if (runs == 0) {
+            continue;
+        }
+
+        // "<2^i:n" counts the runs that took less than 2^i cycles
+        length = snprintk(line, sizeof(line), "  %s: %u runs, max %ld cycles,", stage_names[stage], runs,
+                          atomic_get(&stage_data->max));
+        for (int i = 0; i < GESTURE_STATS_BUCKETS && length < sizeof(line); i++) {
+            atomic_val_t count = atomic_get(&stage_data->histogram[i]);
+            if (count != 0) {
+                length += snprintk(line + length, sizeof(line) - length, " <2^%d:%ld", i, count);
+            }
+        }
+        print(context, line);
+    }
+}
+
+#if CONFIG_INPUT_GESTURES_STATS_LOG_INTERVAL_S > 0
+
+static void gesture_stats_log_line(void *context, const char *line) { LOG_INF("%s", line); }
+
+static void gesture_stats_log_work_handler(struct k_work *work) {
+    LOG_INF("gesture stats, %u cycles per second:", sys_clock_hw_cycles_per_sec());
+    for (int i = 0; i < ARRAY_SIZE(gestures_devices); i++) {
+        gesture_stats_dump(gestures_devices[i], gesture_stats_log_line, NULL);
+    }
+}
+
+#endif
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static void gesture_stats_reset(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    for (int i = 0; i < GESTURE_STATS_COUNTER_COUNT; i++) {
+        atomic_clear(&data->stats.counters[i]);
+    }
+    for (int stage = 0; stage < GESTURE_STATS_STAGE_COUNT; stage++) {
+        for (int i = 0; i < GESTURE_STATS_BUCKETS; i++) {
+            atomic_clear(&data->stats.stages[stage].histogram[i]);
+        }
+        atomic_clear(&data->stats.stages[stage].max);
+    }
+}
+
+static void gesture_stats_shell_line(void *context, const char *line) {
+    shell_print((const struct shell *)context, "%s", line);
+}
+
+static int cmd_gestures_stats(const struct shell *sh, size_t argc, char **argv) {
+    shell_print(sh, "%u cycles per second", sys_clock_hw_cycles_per_sec());
+    for (int i = 0; i < ARRAY_SIZE(gestures_devices); i++) {
+        gesture_stats_dump(gestures_devices[i], gesture_stats_shell_line, (void *)sh);
+    }
+    return 0;
+}
+
+static int cmd_gestures_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    for (int i = 0; i < ARRAY_SIZE(gestures_devices); i++) {
+        gesture_stats_reset(gestures_devices[i]);
+    }
+    shell_print(sh, "gesture stats reset");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_gestures_stats,
+    SHELL_CMD(reset, NULL, "Reset all counters and histograms", cmd_gestures_stats_reset),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((gestures), stats, &sub_gestures_stats, "Show counters and latency histograms", cmd_gestures_stats,
+                 1, 0);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+enum gesture_stats_counter {
+    // events handed to the gestures by the input listener
+    GESTURE_STATS_EVENTS,
+    // coordinates that wait for the end of their frame
+    GESTURE_STATS_HALF_EVENTS,
+    // events that didn't fit into the ring of the gesture thread
+    GESTURE_STATS_RING_OVERFLOWS,
+    GESTURE_STATS_TOUCHES,
+    // arming the timer that detects the end of a touch
+    GESTURE_STATS_TOUCH_END_TIMERS,
+    GESTURE_STATS_REPORTS,
+    // runs of a timer or animation frame of the gestures, these stop while the touchpad rests
+    GESTURE_STATS_WAKEUPS,
+    GESTURE_STATS_COUNTER_COUNT,
+};
+
+enum gesture_stats_stage {
+    // the input processor itself, on the input path
+    GESTURE_STATS_INPUT,
+    GESTURE_STATS_TAP_DETECTION,
+    GESTURE_STATS_CIRCULAR_SCROLL,
+    GESTURE_STATS_INERTIAL_CURSOR,
+    GESTURE_STATS_EDGE_SCROLL,
+    GESTURE_STATS_TWO_FINGER_SCROLL,
+    GESTURE_STATS_PINCH_ZOOM,
+    // one frame of scrolling after a flick
+    GESTURE_STATS_KINETIC_SCROLL,
+    // assembling and sending one mouse report
+    GESTURE_STATS_REPORT,
+    GESTURE_STATS_STAGE_COUNT,
+};
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_STATS)
+
+// bucket i counts the durations in [2^(i-1), 2^i) cycles, the last one everything longer
+#define GESTURE_STATS_BUCKETS 16
+
+struct gesture_stats_stage_data {
+    atomic_t histogram[GESTURE_STATS_BUCKETS];
+    atomic_t max;
+};
+
+struct gesture_stats {
+    atomic_t counters[GESTURE_STATS_COUNTER_COUNT];
+    struct gesture_stats_stage_data stages[GESTURE_STATS_STAGE_COUNT];
+};
+
+static inline uint32_t gesture_stats_start(void) { return k_cycle_get_32(); }
+void gesture_stats_stop(const struct device *dev, enum gesture_stats_stage stage, uint32_t start);
+void gesture_stats_count(const struct device *dev, enum gesture_stats_counter counter);
+
+#else
+
+static inline uint32_t gesture_stats_start(void) { return 0; }
+static inline void gesture_stats_stop(const struct device *dev, enum gesture_stats_stage stage, uint32_t start) {}
+static inline void gesture_stats_count(const struct device *dev, enum gesture_stats_counter counter) {}
+
+#endif
+
+// Runs call and adds its duration to the histogram of stage
+#define GESTURE_STATS_TIMED(dev, stage, call)                                                               \
+    do {                                                                                                    \
+        uint32_t gesture_stats_started = gesture_stats_start();                                             \
+        call;                                                                                               \
+        gesture_stats_stop(dev, stage, gesture_stats_started);                                              \
+    } while (0)
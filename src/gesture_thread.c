@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include "gesture_thread.h"
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+
+K_THREAD_STACK_DEFINE(gestures_work_q_stack, CONFIG_INPUT_GESTURES_THREAD_STACK_SIZE);
+static struct k_work_q gestures_work_q;
+
+struct k_work_q *gestures_work_queue(void) { return &gestures_work_q; }
+
+static int gestures_work_q_init(void) {
+    const struct k_work_queue_config queue_config = {.name = "gestures"};
+
+    k_work_queue_init(&gestures_work_q);
+    k_work_queue_start(&gestures_work_q, gestures_work_q_stack,
+                       K_THREAD_STACK_SIZEOF(gestures_work_q_stack),
+                       CONFIG_INPUT_GESTURES_THREAD_PRIORITY, &queue_config);
+    return 0;
+}
+
+SYS_INIT(gestures_work_q_init, POST_KERNEL, CONFIG_INPUT_GESTURES_INIT_PRIORITY);
+
+#else
+
+struct k_work_q *gestures_work_queue(void) { return &k_sys_work_q; }
+
+#endif
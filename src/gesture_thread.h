@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// With CONFIG_INPUT_GESTURES_THREAD all work of the gestures runs on a dedicated
+// work queue, otherwise on the system work queue.
+struct k_work_q *gestures_work_queue(void);
+
+static inline int gestures_work_reschedule(struct k_work_delayable *work, k_timeout_t delay) {
+    return k_work_reschedule_for_queue(gestures_work_queue(), work, delay);
+}
+
+static inline int gestures_work_schedule(struct k_work_delayable *work, k_timeout_t delay) {
+    return k_work_schedule_for_queue(gestures_work_queue(), work, delay);
+}
+
+static inline int gestures_work_submit(struct k_work *work) {
+    return k_work_submit_to_queue(gestures_work_queue(), work);
+}
@@ -1,129 +1,90 @@
 #include <drivers/input_processor.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
-#include <zmk/hid.h>
-#include <zmk/endpoints.h>
-#include <math.h>
 #include <stdlib.h>
 #include "input_processor_gestures.h"
 #include "inertial_cursor.h"
+#include "gesture_math.h"
 
 LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
 
-#define ANIMATE_MSEC 50
+// below this velocity (1/20 pixel per ms) the cursor comes to a stop
+#define STOP_VELOCITY (FIX16_ONE / 20)
 
-static void inertial_cursor_work_handler(struct k_work *work) {
-    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-    struct inertial_cursor_data *data = CONTAINER_OF(d_work, struct inertial_cursor_data, inertial_work);
+// keeps the distance covered in one frame within fix16_t
+#define MAX_VELOCITY fix16_from_int(100)
 
-    LOG_DBG("data->delta_x: %d, data->delta_y: %d", 
-        (int) data->delta_x, 
-        (int) data->delta_y);
-
-    data->delta_x *= data->velocity_decay;
-    data->delta_y *= data->velocity_decay;
-
-    if (abs((int) data->delta_x) > 0 || abs((int) data->delta_y) > 0) {
-        zmk_hid_mouse_movement_update((int) data->delta_y, (int) -data->delta_x);
-        zmk_endpoints_send_mouse_report();
-        k_work_reschedule(&data->inertial_work, K_MSEC(data->delta_time));
-    }
-}
-
-int inertial_cursor_handle_touch(const struct device *dev, struct gesture_event_t *event) {
-    struct gesture_data *data = (struct gesture_data *)dev->data;
-    struct gesture_config *config = (struct gesture_config *)dev->config;
-
-    if (!config->inertial_cursor.enabled) {
-        return -1;
-    }
-
-    if (event->delta_x != 0) {
-        data->inertial_cursor.delta_x = event->delta_x;
-    }
-
-    if (event->delta_x != 0) {
-        data->inertial_cursor.delta_y = event->delta_y ;
-    }
-
-    if (event->delta_time != 0) {
-        data->inertial_cursor.delta_time = event->delta_time;
-    }
-
-    return 0;
+static void inertial_cursor_step(struct decay_animation *animation, int32_t x, int32_t y) {
+    report_scheduler_move(animation->dev, GESTURES_REPORT_X(x, y), GESTURES_REPORT_Y(x, y));
 }
 
-
-int inertial_cursor_handle_touch_start(const struct device *dev, struct gesture_event_t *event) {
+static int inertial_cursor_handle_touch_start(const struct device *dev, struct gesture_event_t *event) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
-    struct gesture_config *config = (struct gesture_config *)dev->config;
-
-    if (!config->inertial_cursor.enabled) {
-        return -1;
-    }
-
-    k_work_cancel_delayable(&data->inertial_cursor.inertial_work);
 
-    data->inertial_cursor.delta_x = 0;
-    data->inertial_cursor.delta_y = 0;
-    data->inertial_cursor.delta_time = 0;
-
-    inertial_cursor_handle_touch(dev, event);
+    decay_animation_stop(&data->inertial_cursor.animation);
 
     return 0;
 }
 
-int inertial_cursor_handle_end(const struct device *dev) {
+static int inertial_cursor_handle_end(const struct device *dev) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
     struct gesture_config *config = (struct gesture_config *)dev->config;
 
-    if (!config->inertial_cursor.enabled) {
+    fix16_t velocity_x, velocity_y;
+    if (touch_detection_velocity(dev, config->inertial_cursor.velocity_window_ms, &velocity_x, &velocity_y) < 0) {
         return -1;
     }
 
-    double velocity = sqrt(
-        data->inertial_cursor.delta_x * data->inertial_cursor.delta_x + 
-        data->inertial_cursor.delta_y * data->inertial_cursor.delta_y
-        ) / data->inertial_cursor.delta_time;
-
+    fix16_t velocity = fix16_length(velocity_x, velocity_y);
+    fix16_t velocity_threshold = fix16_from_int(config->inertial_cursor.velocity_threshold);
 
     LOG_DBG("velocity: %d, velocity_threshold: %d, too slow: %s", 
-        (int)velocity, 
+        fix16_to_int(velocity), 
         (int) config->inertial_cursor.velocity_threshold, 
-        velocity <= config->inertial_cursor.velocity_threshold?"yes":"no");
+        velocity <= velocity_threshold?"yes":"no");
 
-    if (velocity <= config->inertial_cursor.velocity_threshold) {
+    if (velocity <= velocity_threshold) {
         return -1;
     }
 
-    data->inertial_cursor.delta_x *= data->inertial_cursor.velocity_decay;
-    data->inertial_cursor.delta_y *= data->inertial_cursor.velocity_decay;
-    
-    zmk_hid_mouse_movement_set(0, 0);
-    zmk_endpoints_send_mouse_report();
+    trace_replay_note_decision(TRACE_REPLAY_INERTIAL_CURSOR);
 
-    k_work_reschedule(&data->inertial_cursor.inertial_work, K_MSEC(data->inertial_cursor.delta_time));
+    // the glide continues at the speed the cursor had, not the finger
+    fix16_t gain = acceleration_gain(dev, velocity);
+    velocity_x = fix16_mul(velocity_x, gain);
+    velocity_y = fix16_mul(velocity_y, gain);
+
+    decay_animation_start(&data->inertial_cursor.animation, CLAMP(velocity_x, -MAX_VELOCITY, MAX_VELOCITY),
+                          CLAMP(velocity_y, -MAX_VELOCITY, MAX_VELOCITY));
 
     return 0;
 }
 
-int inertial_cursor_init(const struct device *dev) {
+static int inertial_cursor_init(const struct device *dev) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
     struct gesture_config *config = (struct gesture_config *)dev->config;
 
-    LOG_DBG("inertial_cursor: %s, velocity_threshold: %d, decay_percent: %d", 
-        config->inertial_cursor.enabled ? "yes" : "no", 
+    LOG_DBG("inertial_cursor: velocity_threshold: %d, velocity_window_ms: %d, decay_percent: %d, frame_ms: %d", 
         config->inertial_cursor.velocity_threshold,
-        config->inertial_cursor.decay_percent);
-
+        config->inertial_cursor.velocity_window_ms,
+        config->inertial_cursor.decay_percent,
+        config->inertial_cursor.frame_ms);
 
-    if (!config->inertial_cursor.enabled) {
-        return -1;
-    }
+    // Once a frame covers less than a pixel, the fractions only add up to a single pixel every few
+    // frames. That isn't worth waking up for, so the glide stops there at the latest.
+    fix16_t stop_velocity = MAX(STOP_VELOCITY, FIX16_ONE / MAX(config->inertial_cursor.frame_ms, 1));
 
-    data->inertial_cursor.velocity_decay = (100.0 - config->inertial_cursor.decay_percent) / 100.0;
-    LOG_ERR("velocity_decay *1000: %d", (int) (data->inertial_cursor.velocity_decay * 1000.0));
-
-    k_work_init_delayable(&data->inertial_cursor.inertial_work, inertial_cursor_work_handler);
+    decay_animation_init(&data->inertial_cursor.animation, dev, GESTURE_STATS_INERTIAL_CURSOR, inertial_cursor_step,
+                         config->inertial_cursor.decay_percent, config->inertial_cursor.frame_ms, stop_velocity);
     return 0;
 }
+
+// The inertial cursor only acts once the touch is over, so everything else goes first
+const struct gesture_recognizer inertial_cursor_recognizer = {
+    .name = "inertial cursor",
+    .priority = 10,
+    .stage = GESTURE_STATS_INERTIAL_CURSOR,
+    .init = inertial_cursor_init,
+    .touch_start = inertial_cursor_handle_touch_start,
+    .touch_end = inertial_cursor_handle_end,
+};
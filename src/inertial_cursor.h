@@ -1,23 +1,20 @@
 #pragma once
 
 #include "input_processor_gestures.h"
+#include "gesture_math.h"
+#include "decay_animation.h"
 
 struct inertial_cursor_data {
-    struct k_work_delayable inertial_work;
-    uint16_t previous_x, previous_y;
-    double delta_x, delta_y;
-    uint32_t delta_time;
-    double velocity_decay;
+    // in pixels
+    struct decay_animation animation;
     gesture_data *all;
 };
 
 struct inertial_cursor_config {
-    const bool enabled;
     const uint16_t velocity_threshold;
+    const uint8_t velocity_window_ms;
     const uint8_t decay_percent;
+    const uint8_t frame_ms;
 };
 
-handle_init_t inertial_cursor_init;
-handle_touch_t inertial_cursor_handle_touch_start;
-handle_touch_t inertial_cursor_handle_touch;
-handle_touch_end_t inertial_cursor_handle_end;
+extern const struct gesture_recognizer inertial_cursor_recognizer;
@@ -6,6 +6,7 @@
 
 #define DT_DRV_COMPAT zmk_input_processor_gestures
 
+#include <stdlib.h>
 #include <drivers/input_processor.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
@@ -15,37 +16,226 @@
 #include "tap_detection.h"
 #include "circular_scroll.h"
 #include "inertial_cursor.h"
+#include "edge_scroll.h"
+#include "two_finger_scroll.h"
+#include "pinch_zoom.h"
+#include "report_scheduler.h"
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
 
 
 LOG_MODULE_REGISTER(gestures, CONFIG_ZMK_LOG_LEVEL);
 
-static void handle_init(const struct device *dev) {
-    touch_detection_init(dev);
-    tap_detection_init(dev);
-    circular_scroll_init(dev);
-    inertial_cursor_init(dev);
+#if IS_ENABLED(CONFIG_SHELL) && (IS_ENABLED(CONFIG_INPUT_GESTURES_STATS) || IS_ENABLED(CONFIG_INPUT_GESTURES_LATENCY_TRACE))
+// the stats and the latency trace add their commands with SHELL_SUBCMD_ADD((gestures), ...)
+SHELL_SUBCMD_SET_CREATE(sub_gestures, (gestures));
+SHELL_CMD_REGISTER(gestures, &sub_gestures, "Touchpad gestures", NULL);
+#endif
+
+static void clear_raw_event(struct input_event *raw_event) {
+    if (raw_event == NULL) {
+        return;
+    }
+    raw_event->code = 0;
+    raw_event->type = 0;
+    raw_event->value = 0;
+}
+
+void gestures_drop_raw_events(struct gesture_event_t *event) { clear_raw_event(event->raw_event); }
+
+void gestures_raw_events_to_scroll(const struct device *dev, struct gesture_event_t *event, uint16_t code,
+                                   int32_t value) {
+    if (event == NULL || event->raw_event == NULL) {
+        // in the gesture thread the raw events are long gone, so scroll directly
+        if (code == INPUT_REL_HWHEEL) {
+            report_scheduler_scroll(dev, value, 0);
+        } else {
+            report_scheduler_scroll(dev, 0, value);
+        }
+        return;
+    }
+
+    event->raw_event->code = code;
+    event->raw_event->type = INPUT_EV_REL;
+    event->raw_event->value = value;
+}
+
+bool gestures_scroll(const struct device *dev, struct gesture_event_t *event, struct scroll_accumulator *scroll,
+                     uint16_t code, fix16_t ticks) {
+    scroll->residual += ticks;
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+    // the first whole tick still decides that the touch scrolls, so a tap on the rim doesn't
+    if (report_scheduler_wheel_multiplier(code) > 1 &&
+        (scroll->is_scrolling || abs(scroll->residual) >= FIX16_ONE)) {
+        if (event != NULL) {
+            gestures_drop_raw_events(event);
+        }
+        if (code == INPUT_REL_HWHEEL) {
+            report_scheduler_scroll_fine(dev, scroll->residual, 0);
+        } else {
+            report_scheduler_scroll_fine(dev, 0, scroll->residual);
+        }
+        scroll->residual = 0;
+        scroll->is_scrolling = true;
+        return true;
+    }
+#endif
+
+    int32_t whole_ticks = fix16_to_int(scroll->residual);
+    scroll->residual -= fix16_from_int(whole_ticks);
+
+    if (whole_ticks == 0) {
+        // until the touch scrolls, it might still just move the cursor
+        if (event != NULL && scroll->is_scrolling) {
+            gestures_drop_raw_events(event);
+        }
+        return false;
+    }
+
+    gestures_raw_events_to_scroll(dev, event, code, whole_ticks);
+    scroll->is_scrolling = true;
+    return true;
 }
 
-static int handle_touch_start(const struct device *dev, struct gesture_event_t *event) {
+// Recognizers [from, to) lose the touch to a recognizer with a higher priority
+static void gestures_cancel(const struct device *dev, uint8_t from, uint8_t to) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    for (uint8_t i = from; i < to; i++) {
+        const struct gesture_recognizer *recognizer = data->pipeline.recognizers[i];
+        if (recognizer->cancel != NULL) {
+            LOG_DBG("%s loses the touch", recognizer->name);
+            recognizer->cancel(dev);
+        }
+    }
+}
+
+int gestures_touch_start(const struct device *dev, struct gesture_event_t *event) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
     LOG_DBG("handle_touch_start");
-    circular_scroll_handle_start(dev, event);
-    tap_detection_handle_start(dev, event);
-    inertial_cursor_handle_touch_start(dev, event);
+
+    data->pipeline.active = data->pipeline.len;
+    for (uint8_t i = 0; i < data->pipeline.active; i++) {
+        const struct gesture_recognizer *recognizer = data->pipeline.recognizers[i];
+        int ret = 0;
+        if (recognizer->touch_start != NULL) {
+            GESTURE_STATS_TIMED(dev, recognizer->stage, ret = recognizer->touch_start(dev, event));
+        }
+        if (ret == GESTURE_CLAIM) {
+            LOG_DBG("%s claims the touch", recognizer->name);
+            // the others haven't seen the touch yet, so there's nothing to cancel
+            data->pipeline.active = i + 1;
+        }
+    }
     return 0;
 }
 
-static int handle_touch(const struct device *dev, struct gesture_event_t *event) {
+int gestures_touch(const struct device *dev, struct gesture_event_t *event) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
     LOG_DBG("handle_touch_ongoing");
-    circular_scroll_handle_touch(dev, event);
-    tap_detection_handle_touch(dev, event);
-    inertial_cursor_handle_touch(dev, event);
+
+    if (atomic_test_bit(&data->raw_event_claims, GESTURE_CLAIM_MULTI_TOUCH)) {
+        gestures_drop_raw_events(event);
+    }
+
+    for (uint8_t i = 0; i < data->pipeline.active; i++) {
+        const struct gesture_recognizer *recognizer = data->pipeline.recognizers[i];
+        int ret = 0;
+        if (recognizer->touch != NULL) {
+            GESTURE_STATS_TIMED(dev, recognizer->stage, ret = recognizer->touch(dev, event));
+        }
+        if (ret == GESTURE_CLAIM && i + 1 < data->pipeline.active) {
+            LOG_DBG("%s claims the touch", recognizer->name);
+            gestures_cancel(dev, i + 1, data->pipeline.active);
+            data->pipeline.active = i + 1;
+        }
+    }
     return 0;
 }
 
-static int handle_touch_end(const struct device *dev) {
+int gestures_touch_end(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
     LOG_DBG("handle_touch_end");
-    circular_scroll_handle_end(dev);
-    inertial_cursor_handle_end(dev);
+
+    for (uint8_t i = 0; i < data->pipeline.active; i++) {
+        const struct gesture_recognizer *recognizer = data->pipeline.recognizers[i];
+        if (recognizer->touch_end != NULL) {
+            GESTURE_STATS_TIMED(dev, recognizer->stage, recognizer->touch_end(dev));
+        }
+    }
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+
+int gestures_frame(const struct device *dev, const struct touch_slots *slots) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    struct gesture_pipeline *pipeline = &data->pipeline;
+
+    if (!pipeline->has_frame_recognizers) {
+        return 0;
+    }
+
+    bool multi_touch = touch_slots_count(slots) >= 2;
+    atomic_set_bit_to(&data->raw_event_claims, GESTURE_CLAIM_MULTI_TOUCH, multi_touch);
+
+    if (pipeline->frame_owner < pipeline->len) {
+        const struct gesture_recognizer *owner = pipeline->recognizers[pipeline->frame_owner];
+        GESTURE_STATS_TIMED(dev, owner->stage, owner->frame(dev, slots));
+        if (!multi_touch) {
+            LOG_DBG("%s releases the contacts", owner->name);
+            pipeline->frame_owner = GESTURE_RECOGNIZERS_MAX;
+        }
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < pipeline->len; i++) {
+        const struct gesture_recognizer *recognizer = pipeline->recognizers[i];
+        int ret = 0;
+        if (recognizer->frame != NULL) {
+            GESTURE_STATS_TIMED(dev, recognizer->stage, ret = recognizer->frame(dev, slots));
+        }
+        if (ret == GESTURE_CLAIM) {
+            LOG_DBG("%s claims the contacts", recognizer->name);
+            // everything else loses the touch, no matter its priority
+            gestures_cancel(dev, 0, i);
+            gestures_cancel(dev, i + 1, pipeline->len);
+            pipeline->frame_owner = i;
+            pipeline->active = 0;
+            break;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+// Sorts the recognizers of this instance by priority and initializes them
+static int gestures_pipeline_init(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+
+    data->pipeline.len = 0;
+    for (uint8_t i = 0; i < config->recognizers_len; i++) {
+        const struct gesture_recognizer *recognizer = config->recognizers[i];
+        uint8_t position = data->pipeline.len++;
+
+        while (position > 0 && data->pipeline.recognizers[position - 1]->priority < recognizer->priority) {
+            data->pipeline.recognizers[position] = data->pipeline.recognizers[position - 1];
+            position--;
+        }
+        data->pipeline.recognizers[position] = recognizer;
+    }
+
+    data->pipeline.frame_owner = GESTURE_RECOGNIZERS_MAX;
+    for (uint8_t i = 0; i < data->pipeline.len; i++) {
+        LOG_DBG("recognizer %d: %s", i, data->pipeline.recognizers[i]->name);
+        data->pipeline.has_frame_recognizers |= data->pipeline.recognizers[i]->frame != NULL;
+        data->pipeline.recognizers[i]->init(dev);
+    }
     return 0;
 }
 
@@ -54,12 +244,35 @@ static int gestures_init(const struct device *dev) {
 
     data->dev = dev;
     data->touch_detection.all = data;
+    data->report_scheduler.all = data;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TAP_DETECTION)
     data->tap_detection.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL)
     data->circular_scroll.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR)
     data->inertial_cursor.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_EDGE_SCROLL)
+    data->edge_scroll.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL)
+    data->two_finger_scroll.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    data->pinch_zoom.all = data;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TOUCH_ZONES)
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    touch_zones_init(&data->zones, &config->zones);
+#endif
+    kinetic_scroll_init(dev);
+    acceleration_init(dev);
 
-    handle_init(dev);
-    return 0;
+    report_scheduler_init(dev);
+    touch_detection_init(dev);
+    return gestures_pipeline_init(dev);
 }
 
 
@@ -69,38 +282,155 @@ static const struct zmk_input_processor_driver_api gestures_driver_api = {
 };
 
 
+// Expands to code only if the recognizer is enabled in the devicetree node of instance n
+#define GESTURES_IF(n, recognizer, code) COND_CODE_1(GESTURES_ENABLED(n, recognizer), code, ())
+#define GESTURES_ENABLED(n, recognizer) GESTURES_ENABLED_##recognizer(n)
+#define GESTURES_ENABLED_tap_detection(n) DT_INST_PROP(n, tap_detection)
+#define GESTURES_ENABLED_circular_scroll(n) DT_INST_PROP(n, circular_scroll)
+#define GESTURES_ENABLED_inertial_cursor(n) DT_INST_PROP(n, inertial_cursor)
+#define GESTURES_ENABLED_edge_scroll(n)                                                                     \
+    UTIL_OR(DT_INST_PROP(n, right_side_vertical_scroll), DT_INST_PROP(n, top_side_horizontal_scroll))
+#define GESTURES_ENABLED_two_finger_scroll(n) DT_INST_PROP(n, two_finger_scroll)
+#define GESTURES_ENABLED_pinch_zoom(n) DT_INST_PROP(n, pinch_zoom)
+#define GESTURES_ENABLED_kinetic_scroll(n) DT_INST_PROP(n, kinetic_scroll)
+#define GESTURES_ENABLED_jitter_filter(n) DT_INST_PROP(n, jitter_filter)
+#define GESTURES_ENABLED_acceleration(n) DT_INST_NODE_HAS_PROP(n, acceleration_curve)
+#define GESTURES_ENABLED_pointer_prediction(n) DT_INST_PROP(n, pointer_prediction)
+
+// Recognizers enabled in devicetree also need to be compiled in
+#define GESTURES_CHECK_KCONFIG(n, recognizer, kconfig)                                                      \
+    BUILD_ASSERT(!GESTURES_ENABLED(n, recognizer) || IS_ENABLED(kconfig),                                   \
+                 "gestures node uses " #recognizer " but " #kconfig " is disabled");
+
+// The recognizers of every instance are listed from its devicetree node, so disabled recognizers
+// aren't called at all. Recognizers that no instance uses are removed by the linker.
+#define GESTURES_RECOGNIZERS(n)                                                                             \
+    GESTURES_CHECK_KCONFIG(n, tap_detection, CONFIG_INPUT_GESTURES_TAP_DETECTION)                           \
+    GESTURES_CHECK_KCONFIG(n, circular_scroll, CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL)                       \
+    GESTURES_CHECK_KCONFIG(n, inertial_cursor, CONFIG_INPUT_GESTURES_INERTIAL_CURSOR)                       \
+    GESTURES_CHECK_KCONFIG(n, edge_scroll, CONFIG_INPUT_GESTURES_EDGE_SCROLL)                               \
+    GESTURES_CHECK_KCONFIG(n, two_finger_scroll, CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL)                   \
+    GESTURES_CHECK_KCONFIG(n, pinch_zoom, CONFIG_INPUT_GESTURES_PINCH_ZOOM)                                 \
+    GESTURES_CHECK_KCONFIG(n, kinetic_scroll, CONFIG_INPUT_GESTURES_KINETIC_SCROLL)                         \
+    GESTURES_CHECK_KCONFIG(n, jitter_filter, CONFIG_INPUT_GESTURES_JITTER_FILTER)                           \
+    GESTURES_CHECK_KCONFIG(n, acceleration, CONFIG_INPUT_GESTURES_ACCELERATION)                             \
+    GESTURES_CHECK_KCONFIG(n, pointer_prediction, CONFIG_INPUT_GESTURES_POINTER_PREDICTION)                 \
+    static const struct gesture_recognizer *const gesture_recognizers_##n[] = {                             \
+        GESTURES_IF(n, tap_detection, (&tap_detection_recognizer,))                                         \
+        GESTURES_IF(n, circular_scroll, (&circular_scroll_recognizer,))                                     \
+        GESTURES_IF(n, inertial_cursor, (&inertial_cursor_recognizer,))                                     \
+        GESTURES_IF(n, edge_scroll, (&edge_scroll_recognizer,))                                             \
+        GESTURES_IF(n, two_finger_scroll, (&two_finger_scroll_recognizer,))                                 \
+        GESTURES_IF(n, pinch_zoom, (&pinch_zoom_recognizer,))                                               \
+    };                                                                                                      \
+    BUILD_ASSERT(ARRAY_SIZE(gesture_recognizers_##n) <= GESTURE_RECOGNIZERS_MAX,                            \
+                 "too many recognizers, increase GESTURE_RECOGNIZERS_MAX");
+
 #define GESTURES_INST(n)                                                                                    \
+    GESTURES_RECOGNIZERS(n)                                                                                 \
     static struct gesture_data gesture_data_##n = {                                                         \
     };                                                                                                      \
-    static const struct tap_detection_config tap_detection_config_##n = {                                   \
-        .enabled = DT_INST_PROP(n, tap_detection),                                                          \
-        .tap_timout_ms = DT_INST_PROP(n, tap_timout_ms),                                                    \
-        .prevent_movement_during_tap = DT_INST_PROP(n, prevent_movement_during_tap),                        \
-    };                                                                                                      \
     static const struct touch_detection_config touch_detection_config_##n = {                               \
         .wait_for_new_position_ms = DT_INST_PROP(n, wait_for_new_position_ms),                              \
+        .adaptive_touch_end = DT_INST_PROP(n, adaptive_touch_end),                                          \
+        .adaptive_touch_end_min_ms = DT_INST_PROP(n, adaptive_touch_end_min_ms),                            \
+        .adaptive_touch_end_percent = DT_INST_PROP(n, adaptive_touch_end_percent),                          \
     };                                                                                                      \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_TAP_DETECTION, (                                                       \
+    static const struct tap_detection_config tap_detection_config_##n = {                                   \
+        .tap_timout_ms = DT_INST_PROP(n, tap_timout_ms),                                                    \
+        .prevent_movement_during_tap = DT_INST_PROP(n, prevent_movement_during_tap),                        \
+        .tap_drag = DT_INST_PROP(n, tap_drag),                                                              \
+        .tap_drag_window_ms = DT_INST_PROP(n, tap_drag_window_ms),                                          \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL, (                                                     \
+    BUILD_ASSERT(DT_INST_PROP(n, circular_scroll_degrees_per_tick) > 0,                                     \
+                 "circular-scroll-degrees-per-tick must be at least 1");                                    \
     static const struct circular_scroll_config circular_scroll_config_##n = {                               \
-        .enabled = DT_INST_PROP(n, circular_scroll),                                                        \
-        .circular_scroll_rim_percent = DT_INST_PROP(n, circular_scroll_rim_percent),                        \
-        .width = DT_INST_PROP(n, circular_scroll_width),                                                    \
-        .height = DT_INST_PROP(n, circular_scroll_height),                                                  \
-    };                                                                                                      \
+        .degrees_per_tick = DT_INST_PROP(n, circular_scroll_degrees_per_tick),                              \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR, (                                                     \
     static const struct inertial_cursor_config inertial_cursor_config_##n = {                               \
-        .enabled = DT_INST_PROP(n, inertial_cursor),                                                        \
         .velocity_threshold = DT_INST_PROP(n, inertial_cursor_velocity_threshold),                          \
+        .velocity_window_ms = DT_INST_PROP(n, inertial_cursor_velocity_window_ms),                          \
         .decay_percent = DT_INST_PROP(n, inertial_cursor_decay_percent),                                    \
-    };                                                                                                      \
+        .frame_ms = DT_INST_PROP(n, inertial_cursor_frame_ms),                                              \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_EDGE_SCROLL, (                                                         \
+    BUILD_ASSERT(DT_INST_PROP(n, edge_scroll_pixels_per_tick) > 0,                                          \
+                 "edge-scroll-pixels-per-tick must be at least 1");                                         \
+    static const struct edge_scroll_config edge_scroll_config_##n = {                                       \
+        .pixels_per_tick = DT_INST_PROP(n, edge_scroll_pixels_per_tick),                                    \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL, (                                                   \
+    BUILD_ASSERT(DT_INST_PROP(n, two_finger_scroll_pixels_per_tick) > 0,                                    \
+                 "two-finger-scroll-pixels-per-tick must be at least 1");                                   \
+    static const struct two_finger_scroll_config two_finger_scroll_config_##n = {                           \
+        .pixels_per_tick = DT_INST_PROP(n, two_finger_scroll_pixels_per_tick),                              \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM, (                                                          \
+    BUILD_ASSERT(DT_INST_PROP(n, pinch_zoom_pixels_per_tick) > 0,                                           \
+                 "pinch-zoom-pixels-per-tick must be at least 1");                                          \
+    static const struct pinch_zoom_config pinch_zoom_config_##n = {                                         \
+        .pixels_per_tick = DT_INST_PROP(n, pinch_zoom_pixels_per_tick),                                     \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL, (                                                      \
+    static const struct kinetic_scroll_config kinetic_scroll_config_##n = {                                 \
+        .enabled = DT_INST_PROP(n, kinetic_scroll),                                                         \
+        .threshold = DT_INST_PROP(n, kinetic_scroll_threshold),                                             \
+        .decay_percent = DT_INST_PROP(n, kinetic_scroll_decay_percent),                                     \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_JITTER_FILTER, (                                                       \
+    static const struct jitter_filter_config jitter_filter_config_##n = {                                   \
+        .enabled = DT_INST_PROP(n, jitter_filter),                                                          \
+        .min_cutoff_mhz = DT_INST_PROP(n, jitter_filter_min_cutoff_mhz),                                    \
+        .beta = DT_INST_PROP(n, jitter_filter_beta),                                                        \
+    };))                                                                                                    \
+    GESTURES_IF(n, acceleration, (                                                                          \
+    static const int32_t acceleration_curve_##n[] = DT_INST_PROP(n, acceleration_curve);))                  \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_ACCELERATION, (                                                        \
+    static const struct acceleration_config acceleration_config_##n = {                                     \
+        .curve = COND_CODE_1(GESTURES_ENABLED(n, acceleration), (acceleration_curve_##n), (NULL)),          \
+        .curve_len = DT_INST_PROP_LEN_OR(n, acceleration_curve, 0),                                         \
+        .width = DT_INST_PROP(n, circular_scroll_width),                                                    \
+        .height = DT_INST_PROP(n, circular_scroll_height),                                                  \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_POINTER_PREDICTION, (                                                  \
+    static const struct pointer_prediction_config pointer_prediction_config_##n = {                         \
+        .enabled = DT_INST_PROP(n, pointer_prediction),                                                     \
+        .max_ms = DT_INST_PROP(n, pointer_prediction_max_ms),                                               \
+    };))                                                                                                    \
+    IF_ENABLED(CONFIG_INPUT_GESTURES_TOUCH_ZONES, (                                                         \
+    static const struct touch_zones_config touch_zones_config_##n = {                                       \
+        .width = DT_INST_PROP(n, circular_scroll_width),                                                    \
+        .height = DT_INST_PROP(n, circular_scroll_height),                                                  \
+        .rim_percent = DT_INST_PROP(n, circular_scroll) * DT_INST_PROP(n, circular_scroll_rim_percent),     \
+        .right_percent = DT_INST_PROP(n, right_side_vertical_scroll) *                                      \
+                         DT_INST_PROP(n, right_side_vertical_scroll_percent),                               \
+        .top_percent = DT_INST_PROP(n, top_side_horizontal_scroll) *                                        \
+                       DT_INST_PROP(n, top_side_horizontal_scroll_percent),                                 \
+    };))                                                                                                    \
     static const struct gesture_config gesture_config_##n = {                                               \
-        .handle_touch_start = &handle_touch_start,                                                          \
-        .handle_touch_continue = &handle_touch,                                                             \
-        .handle_touch_end = &handle_touch_end,                                                              \
-        .tap_detection = tap_detection_config_##n,                                                          \
+        .recognizers = gesture_recognizers_##n,                                                             \
+        .recognizers_len = ARRAY_SIZE(gesture_recognizers_##n),                                             \
+        .sensor = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, device),                                             \
+                              (DEVICE_DT_GET(DT_INST_PHANDLE(n, device))), (NULL)),                         \
         .touch_detection = touch_detection_config_##n,                                                      \
-        .circular_scroll = circular_scroll_config_##n,                                                      \
-        .inertial_cursor = inertial_cursor_config_##n,                                                      \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_TAP_DETECTION, (.tap_detection = tap_detection_config_##n,))       \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL, (.circular_scroll = circular_scroll_config_##n,)) \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR, (.inertial_cursor = inertial_cursor_config_##n,)) \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_EDGE_SCROLL, (.edge_scroll = edge_scroll_config_##n,))             \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_TOUCH_ZONES, (.zones = touch_zones_config_##n,))                   \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL,                                                 \
+                   (.two_finger_scroll = two_finger_scroll_config_##n,))                                    \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM, (.pinch_zoom = pinch_zoom_config_##n,))                \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL, (.kinetic_scroll = kinetic_scroll_config_##n,))    \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_JITTER_FILTER, (.jitter_filter = jitter_filter_config_##n,))       \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_ACCELERATION, (.acceleration = acceleration_config_##n,))          \
+        IF_ENABLED(CONFIG_INPUT_GESTURES_POINTER_PREDICTION,                                                \
+                   (.pointer_prediction = pointer_prediction_config_##n,))                                  \
     };                                                                                                      \
-    DEVICE_DT_INST_DEFINE(n, gestures_init, (struct pm_device *)DEVICE_DT_GET(DT_NODELABEL(glidepoint)), &gesture_data_##n,                    \
+    DEVICE_DT_INST_DEFINE(n, gestures_init, NULL, &gesture_data_##n,                                        \
                           &gesture_config_##n, POST_KERNEL, CONFIG_INPUT_GESTURES_INIT_PRIORITY,            \
                           &gestures_driver_api);
 
@@ -7,14 +7,29 @@
 #pragma once
 
 #include <drivers/input_processor.h>
+#include "gesture_math.h"
+#include "trace_replay.h"
+#include "gesture_thread.h"
+#include "gesture_stats.h"
+
+// The gestures report in the orientation of the inertial cursor: the touchpad turned by a quarter,
+// so that its y axis points right and its x axis points up. It's what
+// zip_xy_transform (INPUT_TRANSFORM_XY_SWAP | INPUT_TRANSFORM_Y_INVERT) does to the raw movement
+// in the examples. Edges and scroll directions of the gestures are in this orientation as well.
+#define GESTURES_REPORT_X(x, y) (y)
+#define GESTURES_REPORT_Y(x, y) (-(x))
+
+// Use this instead of k_uptime_get(), so that replayed traces can inject their own timestamps.
+#define gestures_uptime_get() trace_replay_uptime_get()
 
 struct gesture_event_t {
     uint32_t last_touch_timestamp, previous_touch_timestamp, delta_time;
     uint16_t x, y, previous_x, previous_y;
     int delta_x, delta_y;
     bool absolute;
-    struct input_event *raw_event_1;
-    struct input_event *raw_event_2;
+    // the event that ended the frame of this position, NULL in the gesture thread. The other
+    // events of the frame are dropped by the raw event claims.
+    struct input_event *raw_event;
 };
 
 typedef struct gesture_data gesture_data;
@@ -23,32 +38,185 @@ typedef struct gesture_config_t gesture_config;
 typedef int (handle_init_t)(const struct device *dev);
 typedef int (handle_touch_t)(const struct device *dev, struct gesture_event_t *event);
 typedef int (handle_touch_end_t)(const struct device *dev);
+struct touch_slots;
+typedef int (handle_frame_t)(const struct device *dev, const struct touch_slots *slots);
+
+// Returned by a touch handler to claim the touch: recognizers with a lower priority don't see the rest of it
+#define GESTURE_CLAIM 1
+
+struct gesture_recognizer {
+    const char *name;
+    // recognizers with a higher priority see every event first
+    uint8_t priority;
+    enum gesture_stats_stage stage;
+    handle_init_t *init;
+    // the other handlers are optional
+    handle_touch_t *touch_start;
+    handle_touch_t *touch;
+    handle_touch_end_t *touch_end;
+    // a recognizer with a higher priority claimed the touch after this one saw it start, or a
+    // multi-touch recognizer claimed the contacts
+    handle_touch_end_t *cancel;
+    // all contacts of a multi-touch touchpad, after every frame in which they changed
+    handle_frame_t *frame;
+};
+
+#define GESTURE_RECOGNIZERS_MAX 8
+
+struct gesture_pipeline {
+    // the recognizers enabled in devicetree, highest priority first
+    const struct gesture_recognizer *recognizers[GESTURE_RECOGNIZERS_MAX];
+    uint8_t len;
+    // only the first active recognizers see the ongoing touch
+    uint8_t active;
+    // the multi-touch recognizer that claimed the contacts, GESTURE_RECOGNIZERS_MAX for none
+    uint8_t frame_owner;
+    bool has_frame_recognizers;
+};
+
+// Called by touch_detection for every touch, runs the recognizers by priority
+handle_touch_t gestures_touch_start;
+handle_touch_t gestures_touch;
+handle_touch_end_t gestures_touch_end;
+// Called by touch_detection at the end of every frame of a multi-touch touchpad
+handle_frame_t gestures_frame;
+
+// Recognizers that drop or rewrite the raw events of a touch additionally claim them, so that the
+// input path can drop them by itself when the recognizers run in the gesture thread.
+enum gesture_raw_event_claim {
+    GESTURE_CLAIM_TAP,
+    GESTURE_CLAIM_CIRCULAR_SCROLL,
+    GESTURE_CLAIM_EDGE_SCROLL,
+    // at least two fingers are down, so the cursor doesn't follow any of them
+    GESTURE_CLAIM_MULTI_TOUCH,
+};
+
+void gestures_drop_raw_events(struct gesture_event_t *event);
+// code is INPUT_REL_WHEEL or INPUT_REL_HWHEEL
+void gestures_raw_events_to_scroll(const struct device *dev, struct gesture_event_t *event, uint16_t code,
+                                   int32_t value);
+
+// Scroll movement of one axis of a gesture that hasn't been sent yet
+struct scroll_accumulator {
+    // in wheel ticks, always less than one tick unless it's scrolled in fractions of a tick
+    fix16_t residual;
+    // the first whole tick has been scrolled in this touch
+    bool is_scrolling;
+};
+
+static inline void scroll_accumulator_reset(struct scroll_accumulator *scroll) {
+    scroll->residual = 0;
+    scroll->is_scrolling = false;
+}
+
+// Adds ticks to scroll and scrolls as much of it as the host resolves: whole ticks, or every
+// fraction of a tick once the first whole one is scrolled with CONFIG_INPUT_GESTURES_HIRES_SCROLL.
+// Once the touch scrolls, the raw events of event are rewritten or dropped, before that they pass
+// through. event is NULL for multi-touch frames.
+// Returns true if it scrolled.
+bool gestures_scroll(const struct device *dev, struct gesture_event_t *event, struct scroll_accumulator *scroll,
+                     uint16_t code, fix16_t ticks);
 
 #include "touch_detection.h"
 #include "tap_detection.h"
 #include "circular_scroll.h"
 #include "inertial_cursor.h"
+#include "edge_scroll.h"
+#include "touch_zones.h"
+#include "two_finger_scroll.h"
+#include "pinch_zoom.h"
+#include "kinetic_scroll.h"
+#include "report_scheduler.h"
+#include "acceleration.h"
+#include "pointer_prediction.h"
 
 struct gesture_data {
     const struct device *dev;
+    atomic_t raw_event_claims;
+    struct gesture_pipeline pipeline;
     
     // I would prefer these to be pointers, but then dereferencing
     // the embedded k_work_delayable in there doesn't work:
     // &gesture_data->touch_detection.touch_end_timeout_work crashes 
     // the firmware :/
     struct touch_detection_data touch_detection;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TAP_DETECTION)
     struct tap_detection_data tap_detection;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL)
     struct circular_scroll_data circular_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR)
     struct inertial_cursor_data inertial_cursor;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_EDGE_SCROLL)
+    struct edge_scroll_data edge_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TOUCH_ZONES)
+    struct touch_zones zones;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL)
+    struct two_finger_scroll_data two_finger_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    struct pinch_zoom_data pinch_zoom;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL)
+    struct kinetic_scroll_data kinetic_scroll;
+#endif
+    struct report_scheduler_data report_scheduler;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_ACCELERATION)
+    // runs on the input path even with the gesture thread, so it can rewrite the raw events
+    struct acceleration_data acceleration;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_POINTER_PREDICTION)
+    struct pointer_prediction_data pointer_prediction;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_STATS)
+    struct gesture_stats stats;
+#endif
 };
 
 struct gesture_config {
-    handle_touch_t *handle_touch_start;
-    handle_touch_t *handle_touch_continue;
-    handle_touch_end_t *handle_touch_end;
+    // generated per instance, only the recognizers enabled in its devicetree node
+    const struct gesture_recognizer *const *recognizers;
+    uint8_t recognizers_len;
+
+    // only events of this device are handled, or of all devices if it's NULL
+    const struct device *sensor;
     
     struct touch_detection_config touch_detection;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TAP_DETECTION)
     struct tap_detection_config tap_detection;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_CIRCULAR_SCROLL)
     struct circular_scroll_config circular_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_INERTIAL_CURSOR)
     struct inertial_cursor_config inertial_cursor;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_EDGE_SCROLL)
+    struct edge_scroll_config edge_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TOUCH_ZONES)
+    struct touch_zones_config zones;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TWO_FINGER_SCROLL)
+    struct two_finger_scroll_config two_finger_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    struct pinch_zoom_config pinch_zoom;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL)
+    struct kinetic_scroll_config kinetic_scroll;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_JITTER_FILTER)
+    struct jitter_filter_config jitter_filter;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_ACCELERATION)
+    struct acceleration_config acceleration;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_POINTER_PREDICTION)
+    struct pointer_prediction_config pointer_prediction;
+#endif
 };
\ No newline at end of file
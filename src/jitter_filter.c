@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "input_processor_gestures.h"
+#include "jitter_filter.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+// the velocity itself is smoothed with this fixed cutoff, like in the paper
+#define VELOCITY_CUTOFF_MHZ 1000
+
+// keeps the smoothing factor within 64 bits even for long steps
+#define MAX_CUTOFF_MHZ 1000000
+
+// 2 * pi in thousandths
+#define TWO_PI_MILLI 6283
+
+// Smoothing factor of a low-pass filter with this cutoff for a step of dt_ms:
+// 1 / (1 + tau / dt) with tau = 1 / (2 * pi * cutoff)
+static fix16_t smoothing_factor(uint32_t cutoff_mhz, uint32_t dt_ms) {
+    // 2 * pi * cutoff * dt in millionths
+    uint64_t scaled = (uint64_t)TWO_PI_MILLI * cutoff_mhz * dt_ms / 1000;
+    return (fix16_t)((scaled << FIX16_SHIFT) / (scaled + 1000000));
+}
+
+static int32_t jitter_filter_axis_apply(const struct jitter_filter_config *config, struct jitter_filter_axis *axis,
+                                        int32_t value, uint32_t timestamp, uint32_t new_touch_ms) {
+    fix16_t raw = fix16_from_int(value);
+    uint32_t dt = timestamp - axis->timestamp;
+
+    axis->timestamp = timestamp;
+
+    // a new touch starts wherever the finger is
+    if (!axis->is_filtering || dt > new_touch_ms) {
+        axis->is_filtering = true;
+        axis->position = raw;
+        axis->velocity = 0;
+        return value;
+    }
+
+    dt = MAX(dt, 1);
+
+    fix16_t velocity = (raw - axis->position) / (int32_t)dt;
+    axis->velocity += fix16_mul(smoothing_factor(VELOCITY_CUTOFF_MHZ, dt), velocity - axis->velocity);
+
+    uint32_t cutoff =
+        config->min_cutoff_mhz + (uint32_t)(((uint64_t)config->beta * abs(axis->velocity) * 1000) >> FIX16_SHIFT);
+    axis->position += fix16_mul(smoothing_factor(MIN(cutoff, MAX_CUTOFF_MHZ), dt), raw - axis->position);
+
+    // rounded, so that jitter around a resting finger doesn't move it
+    return fix16_to_int(axis->position + FIX16_ONE / 2);
+}
+
+void jitter_filter_event(const struct device *dev, struct input_event *event, uint32_t timestamp) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    struct jitter_filter_axis *axis;
+
+    if (!config->jitter_filter.enabled || event->type != INPUT_EV_ABS) {
+        return;
+    }
+
+    if (event->code == INPUT_ABS_X) {
+        axis = &data->touch_detection.jitter_filter.x;
+    } else if (event->code == INPUT_ABS_Y) {
+        axis = &data->touch_detection.jitter_filter.y;
+    } else {
+        return;
+    }
+
+    event->value = jitter_filter_axis_apply(&config->jitter_filter, axis, event->value, timestamp,
+                                            config->touch_detection.wait_for_new_position_ms);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+#include "gesture_math.h"
+
+// One axis of the 1€ filter: a low-pass filter whose cutoff rises with the velocity, so a resting
+// finger stays put and a moving one barely lags behind.
+struct jitter_filter_axis {
+    // the filtered position in pixels and its velocity in pixels per ms
+    fix16_t position, velocity;
+    uint32_t timestamp;
+    bool is_filtering;
+};
+
+struct jitter_filter_data {
+    struct jitter_filter_axis x, y;
+};
+
+struct jitter_filter_config {
+    const bool enabled;
+    // cutoff of a resting finger
+    const uint16_t min_cutoff_mhz;
+    // the cutoff rises by beta / 1000 Hz per pixel per second of velocity
+    const uint16_t beta;
+};
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_JITTER_FILTER)
+
+// Replaces the value of an ABS_X or ABS_Y event with the filtered position, before anything else
+// sees it. Other events stay as they are.
+void jitter_filter_event(const struct device *dev, struct input_event *event, uint32_t timestamp);
+
+#else
+
+static inline void jitter_filter_event(const struct device *dev, struct input_event *event, uint32_t timestamp) {}
+
+#endif
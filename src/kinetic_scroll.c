@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "input_processor_gestures.h"
+#include "kinetic_scroll.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+#define KINETIC_SCROLL_FRAME_MS 10
+
+// the animation moves in steps of a fraction of a tick if those can be scrolled
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+#define STEPS_PER_TICK 16
+#else
+#define STEPS_PER_TICK 1
+#endif
+
+// below this velocity (one tick per second) scrolling comes to a stop
+#define STOP_VELOCITY (STEPS_PER_TICK * FIX16_ONE / 1000)
+
+// in ticks per ms, so that a glitch of the touchpad doesn't scroll the page away
+#define MAX_VELOCITY fix16_from_int(10)
+
+static void kinetic_scroll_step(struct decay_animation *animation, int32_t horizontal, int32_t vertical) {
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+    report_scheduler_scroll_fine(animation->dev, horizontal * (FIX16_ONE / STEPS_PER_TICK),
+                                 vertical * (FIX16_ONE / STEPS_PER_TICK));
+#else
+    report_scheduler_scroll(animation->dev, horizontal, vertical);
+#endif
+}
+
+void kinetic_scroll_init(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    LOG_DBG("kinetic_scroll: enabled: %s, threshold: %d, decay_percent: %d",
+        config->kinetic_scroll.enabled ? "yes" : "no",
+        config->kinetic_scroll.threshold,
+        config->kinetic_scroll.decay_percent);
+
+    decay_animation_init(&data->kinetic_scroll.animation, dev, GESTURE_STATS_KINETIC_SCROLL, kinetic_scroll_step,
+                         config->kinetic_scroll.decay_percent, KINETIC_SCROLL_FRAME_MS, STOP_VELOCITY);
+}
+
+void kinetic_scroll_start(const struct device *dev, fix16_t horizontal, fix16_t vertical) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    if (!config->kinetic_scroll.enabled) {
+        return;
+    }
+
+    fix16_t threshold = config->kinetic_scroll.threshold * FIX16_ONE / 1000;
+    LOG_DBG("scroll velocity in ticks per second: %d, %d",
+        fix16_to_int(horizontal * 1000), fix16_to_int(vertical * 1000));
+
+    if (fix16_length(horizontal, vertical) <= threshold) {
+        return;
+    }
+
+    trace_replay_note_decision(TRACE_REPLAY_KINETIC_SCROLL);
+    decay_animation_start(&data->kinetic_scroll.animation,
+                          CLAMP(horizontal, -MAX_VELOCITY, MAX_VELOCITY) * STEPS_PER_TICK,
+                          CLAMP(vertical, -MAX_VELOCITY, MAX_VELOCITY) * STEPS_PER_TICK);
+}
+
+void kinetic_scroll_stop(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    decay_animation_stop(&data->kinetic_scroll.animation);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "input_processor_gestures.h"
+#include "decay_animation.h"
+#include "gesture_math.h"
+
+// Circular and edge scroll keep scrolling after a flick. They never scroll in the same touch, so
+// they share one animation.
+struct kinetic_scroll_data {
+    // in wheel ticks, or sixteenths of a tick with CONFIG_INPUT_GESTURES_HIRES_SCROLL
+    struct decay_animation animation;
+};
+
+struct kinetic_scroll_config {
+    const bool enabled;
+    // ticks per second that start kinetic scrolling
+    const uint16_t threshold;
+    const uint8_t decay_percent;
+};
+
+// The velocity at the end of a touch is fitted through the positions of this last part of it
+#define KINETIC_SCROLL_VELOCITY_WINDOW_MS 50
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_KINETIC_SCROLL)
+
+void kinetic_scroll_init(const struct device *dev);
+
+// Keeps scrolling with this velocity in ticks per ms if kinetic scrolling is enabled and it's
+// fast enough
+void kinetic_scroll_start(const struct device *dev, fix16_t horizontal, fix16_t vertical);
+
+void kinetic_scroll_stop(const struct device *dev);
+
+#else
+
+static inline void kinetic_scroll_init(const struct device *dev) {}
+static inline void kinetic_scroll_start(const struct device *dev, fix16_t horizontal, fix16_t vertical) {}
+static inline void kinetic_scroll_stop(const struct device *dev) {}
+
+#endif
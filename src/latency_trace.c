@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+#include "input_processor_gestures.h"
+#include "latency_trace.h"
+
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+#define RING_SIZE CONFIG_INPUT_GESTURES_LATENCY_TRACE_BUFFER_SIZE
+
+// header, delta, code and value with their longest varints
+#define MAX_RECORD_LENGTH 16
+
+// bytes of the ring per line of a dump
+#define DUMP_LINE_BYTES 32
+
+#define VARINT_MORE BIT(7)
+
+BUILD_ASSERT(RING_SIZE >= MAX_RECORD_LENGTH, "the ring must hold at least one record");
+
+// All touchpads share one ring, just like they share one mouse report. The oldest records are
+// overwritten, so the ring always holds the most recent input.
+struct latency_trace_ring {
+    struct k_spinlock lock;
+    uint8_t buffer[RING_SIZE];
+    // the oldest record starts at tail
+    uint32_t tail, len;
+    // cycles at the time of the newest record, the deltas keep going across dumps
+    uint32_t last_cycles;
+    // records lost since the last dump, so the next one doesn't continue seamlessly
+    uint32_t dropped;
+    bool is_dumping;
+};
+
+static struct latency_trace_ring ring;
+
+static uint8_t ring_at(uint32_t index) { return ring.buffer[index % RING_SIZE]; }
+
+static uint32_t varint_length(uint32_t index) {
+    uint32_t length = 1;
+    while (ring_at(index + length - 1) & VARINT_MORE) {
+        length++;
+    }
+    return length;
+}
+
+static uint32_t oldest_record_length(void) {
+    uint32_t index = ring.tail;
+    uint8_t kind = ring_at(index) & BIT_MASK(LATENCY_TRACE_KIND_BITS);
+
+    index++;
+    index += varint_length(index);
+    if (kind == LATENCY_TRACE_EVENT) {
+        index += varint_length(index);
+        index += varint_length(index);
+    }
+    return index - ring.tail;
+}
+
+static uint32_t put_varint(uint8_t *record, uint32_t length, uint32_t value) {
+    while (value >= VARINT_MORE) {
+        record[length++] = (value & BIT_MASK(7)) | VARINT_MORE;
+        value >>= 7;
+    }
+    record[length++] = value;
+    return length;
+}
+
+// Must be called with the lock held
+static void ring_append(const uint8_t *record, uint32_t length) {
+    while (RING_SIZE - ring.len < length) {
+        uint32_t oldest = oldest_record_length();
+        ring.tail = (ring.tail + oldest) % RING_SIZE;
+        ring.len -= oldest;
+        ring.dropped++;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        ring.buffer[(ring.tail + ring.len + i) % RING_SIZE] = record[i];
+    }
+    ring.len += length;
+}
+
+static void latency_trace_record(uint8_t header, bool is_event, uint16_t code, int32_t value) {
+    uint8_t record[MAX_RECORD_LENGTH];
+    uint32_t length = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&ring.lock);
+
+    if (ring.is_dumping) {
+        ring.dropped++;
+        k_spin_unlock(&ring.lock, key);
+        return;
+    }
+
+    uint32_t now = k_cycle_get_32();
+    record[length++] = header;
+    length = put_varint(record, length, now - ring.last_cycles);
+    ring.last_cycles = now;
+
+    if (is_event) {
+        length = put_varint(record, length, code);
+        // zigzag keeps small negative values short
+        length = put_varint(record, length, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+    }
+
+    ring_append(record, length);
+    k_spin_unlock(&ring.lock, key);
+}
+
+void latency_trace_event(const struct input_event *event) {
+    latency_trace_record(LATENCY_TRACE_EVENT | (event->sync ? BIT(3) : 0) | (event->type << 4), true, event->code,
+                         event->value);
+}
+
+void latency_trace_decision(uint8_t decision) {
+    latency_trace_record(LATENCY_TRACE_DECISION | (decision << LATENCY_TRACE_KIND_BITS), false, 0, 0);
+}
+
+void latency_trace_report(void) { latency_trace_record(LATENCY_TRACE_REPORT, false, 0, 0); }
+
+void latency_trace_dump(void) {
+    char line[2 * DUMP_LINE_BYTES + 1];
+
+    // the ring stays as it is while it's logged, records in the meantime are dropped
+    k_spinlock_key_t key = k_spin_lock(&ring.lock);
+    ring.is_dumping = true;
+    uint32_t tail = ring.tail, len = ring.len, dropped = ring.dropped;
+    k_spin_unlock(&ring.lock, key);
+
+    LOG_INF("latency trace: begin %u %u %u", sys_clock_hw_cycles_per_sec(), len, dropped);
+    for (uint32_t offset = 0; offset < len; offset += DUMP_LINE_BYTES) {
+        uint32_t line_len = MIN(DUMP_LINE_BYTES, len - offset);
+        for (uint32_t i = 0; i < line_len; i++) {
+            snprintk(&line[2 * i], 3, "%02x", ring_at(tail + offset + i));
+        }
+        LOG_INF("latency trace: data %s", line);
+    }
+    LOG_INF("latency trace: end");
+
+    key = k_spin_lock(&ring.lock);
+    ring.tail = 0;
+    ring.len = 0;
+    ring.dropped -= dropped;
+    ring.is_dumping = false;
+    k_spin_unlock(&ring.lock, key);
+}
+
+#if CONFIG_INPUT_GESTURES_LATENCY_TRACE_DUMP_INTERVAL_S > 0
+
+static void latency_trace_dump_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(latency_trace_dump_work, latency_trace_dump_work_handler);
+
+static void latency_trace_dump_work_handler(struct k_work *work) {
+    latency_trace_dump();
+    gestures_work_reschedule(&latency_trace_dump_work, K_SECONDS(CONFIG_INPUT_GESTURES_LATENCY_TRACE_DUMP_INTERVAL_S));
+}
+
+static int latency_trace_dump_init(void) {
+    gestures_work_reschedule(&latency_trace_dump_work, K_SECONDS(CONFIG_INPUT_GESTURES_LATENCY_TRACE_DUMP_INTERVAL_S));
+    return 0;
+}
+
+SYS_INIT(latency_trace_dump_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static int cmd_gestures_trace(const struct shell *sh, size_t argc, char **argv) {
+    latency_trace_dump();
+    shell_print(sh, "latency trace logged");
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((gestures), trace, NULL, "Log the latency trace and empty it", cmd_gestures_trace, 1, 0);
+
+#endif
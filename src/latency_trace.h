@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+
+// Every record starts with a header byte, the kind in the low bits, followed by the cycles of
+// k_cycle_get_32() since the previous record as varint (7 bits per byte, least significant first,
+// the high bit set on all but the last byte):
+// - event: header | sync << 3 | type << 4, delta, code as varint, value zigzag encoded as varint
+// - decision: header | decision << 3, delta
+// - report: header, delta
+// scripts/latency_trace.py decodes the dumps of the ring.
+enum latency_trace_kind {
+    LATENCY_TRACE_EVENT,
+    LATENCY_TRACE_DECISION,
+    LATENCY_TRACE_REPORT,
+};
+
+#define LATENCY_TRACE_KIND_BITS 3
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_LATENCY_TRACE)
+
+// An event of the touchpad entered the gestures
+void latency_trace_event(const struct input_event *event);
+// decision is one of enum trace_replay_decision
+void latency_trace_decision(uint8_t decision);
+// The gestures are about to send a report
+void latency_trace_report(void);
+
+// Logs the ring as hex and empties it
+void latency_trace_dump(void);
+
+#else
+
+static inline void latency_trace_event(const struct input_event *event) {}
+static inline void latency_trace_decision(uint8_t decision) {}
+static inline void latency_trace_report(void) {}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <drivers/input_processor.h>
+#include <zephyr/logging/log.h>
+
+#include "input_processor_gestures.h"
+#include "pinch_zoom.h"
+#include "gesture_math.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+static int pinch_zoom_handle_cancel(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    data->pinch_zoom.is_tracking = false;
+    return 0;
+}
+
+static int pinch_zoom_handle_frame(const struct device *dev, const struct touch_slots *slots) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct pinch_zoom_data *data = &((struct gesture_data *)dev->data)->pinch_zoom;
+    uint8_t first, second;
+
+    if (touch_slots_count(slots) != 2) {
+        return pinch_zoom_handle_cancel(dev);
+    }
+
+    touch_slots_first_two(slots, &first, &second);
+    fix16_t distance = fix16_hypot(slots->x[first] - slots->x[second], slots->y[first] - slots->y[second]);
+
+    if (!data->is_tracking || data->first != first || data->second != second) {
+        data->is_tracking = true;
+        data->first = first;
+        data->second = second;
+        data->previous_distance = distance;
+        data->residual = 0;
+        return 0;
+    }
+
+    data->residual += distance - data->previous_distance;
+    data->previous_distance = distance;
+
+    // spreading the fingers zooms in
+    fix16_t per_tick = fix16_from_int(config->pinch_zoom.pixels_per_tick);
+    int32_t ticks = data->residual / per_tick;
+    data->residual -= ticks * per_tick;
+
+    if (ticks == 0) {
+        return 0;
+    }
+
+    report_scheduler_zoom(dev, ticks);
+    return GESTURE_CLAIM;
+}
+
+static int pinch_zoom_init(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    LOG_DBG("pinch_zoom: pixels_per_tick: %d", config->pinch_zoom.pixels_per_tick);
+    return 0;
+}
+
+// Before two finger scroll, whichever of them moves by a whole tick first takes both fingers
+const struct gesture_recognizer pinch_zoom_recognizer = {
+    .name = "pinch zoom",
+    .priority = 50,
+    .stage = GESTURE_STATS_PINCH_ZOOM,
+    .init = pinch_zoom_init,
+    .frame = pinch_zoom_handle_frame,
+    .cancel = pinch_zoom_handle_cancel,
+};
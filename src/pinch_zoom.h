@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "input_processor_gestures.h"
+#include "gesture_math.h"
+
+struct pinch_zoom_data {
+    bool is_tracking;
+    uint8_t first, second;
+    fix16_t previous_distance;
+    // change of the distance that hasn't been zoomed yet, always less than one tick
+    fix16_t residual;
+    gesture_data *all;
+};
+
+struct pinch_zoom_config {
+    const uint16_t pixels_per_tick;
+};
+
+extern const struct gesture_recognizer pinch_zoom_recognizer;
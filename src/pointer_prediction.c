@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "input_processor_gestures.h"
+#include "pointer_prediction.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+// the prediction reaches its full length after this many positions of a steady movement
+#define RAMP_POSITIONS 4
+
+// each new velocity moves the smoothed one by half of the difference
+#define VELOCITY_WEIGHT_SHIFT 1
+
+// keeps the offset within reason when a sensor glitches
+#define MAX_VELOCITY fix16_from_int(100)
+
+// How far ahead of the finger the cursor should be: the raw movement goes to the input listener
+// as soon as its frame is complete, so a position is as old as the time the touchpad takes for one,
+// but never further than configured
+static uint32_t pointer_prediction_horizon(const struct device *dev) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    uint32_t latency = touch_detection_interval(dev) >> TOUCH_INTERVAL_SHIFT;
+
+    return MIN(latency, config->pointer_prediction.max_ms);
+}
+
+// Returns how far ahead of the new position the cursor should be
+static int32_t pointer_prediction_axis_apply(struct pointer_prediction_axis *axis, int32_t position, uint32_t dt,
+                                             uint32_t horizon) {
+    fix16_t velocity = CLAMP(fix16_from_int(position - axis->position) / (int32_t)dt, -MAX_VELOCITY, MAX_VELOCITY);
+
+    axis->position = position;
+
+    // a reversal would overshoot in the old direction, so start over from the new one
+    if ((velocity < 0 && axis->velocity > 0) || (velocity > 0 && axis->velocity < 0)) {
+        axis->velocity = velocity;
+        axis->steady = 0;
+    } else {
+        axis->velocity += (velocity - axis->velocity) >> VELOCITY_WEIGHT_SHIFT;
+        axis->steady = MIN(axis->steady + 1, RAMP_POSITIONS);
+    }
+
+    int64_t offset = (int64_t)axis->velocity * horizon * axis->steady / RAMP_POSITIONS;
+    return fix16_to_int((fix16_t)offset);
+}
+
+void pointer_prediction_event(const struct device *dev, struct input_event *event, uint32_t timestamp) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    struct pointer_prediction_data *prediction = &data->pointer_prediction;
+    struct pointer_prediction_axis *axis;
+
+    // relative movement has no position to take the prediction back to, so the cursor would end
+    // every touch displaced by the last offset
+    if (!config->pointer_prediction.enabled || event->type != INPUT_EV_ABS) {
+        return;
+    }
+
+    if (event->code == INPUT_ABS_X) {
+        axis = &prediction->x;
+    } else if (event->code == INPUT_ABS_Y) {
+        axis = &prediction->y;
+    } else {
+        return;
+    }
+
+    uint32_t dt = timestamp - axis->timestamp;
+
+    axis->timestamp = timestamp;
+
+    if (dt > config->touch_detection.wait_for_new_position_ms) {
+        // nothing to predict from at the start of a touch
+        axis->position = event->value;
+        axis->velocity = 0;
+        axis->steady = 0;
+        return;
+    }
+
+    event->value += pointer_prediction_axis_apply(axis, event->value, MAX(dt, 1), pointer_prediction_horizon(dev));
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+#include "gesture_math.h"
+
+// One axis of the predictor: the position reported to the input processors after the gestures is
+// ahead of the finger by the smoothed velocity.
+struct pointer_prediction_axis {
+    int32_t position;
+    uint32_t timestamp;
+    // pixels per ms
+    fix16_t velocity;
+    // positions since the touch started or the axis reversed, the prediction ramps up with them
+    uint8_t steady;
+};
+
+struct pointer_prediction_data {
+    struct pointer_prediction_axis x, y;
+};
+
+struct pointer_prediction_config {
+    const bool enabled;
+    // the prediction never reaches further ahead than this
+    const uint8_t max_ms;
+};
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_POINTER_PREDICTION)
+
+// Moves the position of an ABS_X/ABS_Y event ahead by the latency of the pipeline, for the input
+// processors after the gestures. The gestures themselves see the finger. Relative movement passes
+// unchanged.
+void pointer_prediction_event(const struct device *dev, struct input_event *event, uint32_t timestamp);
+
+#else
+
+static inline void pointer_prediction_event(const struct device *dev, struct input_event *event,
+                                            uint32_t timestamp) {}
+
+#endif
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <drivers/input_processor.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include <zmk/endpoints.h>
+#include <zmk/hid.h>
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+#include <zmk/pointing/resolution_multipliers.h>
+#endif
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include <dt-bindings/zmk/modifiers.h>
+#include "input_processor_gestures.h"
+#include "report_scheduler.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+#define BUTTON_EDGE_PRESSED BIT(7)
+#define BUTTON_EDGE_BUTTON(edge) ((edge) & ~BUTTON_EDGE_PRESSED)
+
+static int32_t pending_zoom(struct report_scheduler_data *data) {
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    return data->zoom;
+#else
+    return 0;
+#endif
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+
+int32_t report_scheduler_wheel_multiplier(uint16_t code) {
+    struct zmk_pointing_resolution_multipliers multipliers =
+        zmk_pointing_resolution_multipliers_get_current_profile();
+
+    // the host sets the logical value of the multiplier, 0 to 15 for 1 to 16 units per tick
+    return (code == INPUT_REL_HWHEEL ? multipliers.hor_wheel : multipliers.wheel) + 1;
+}
+
+// The wheel units that can be sent of ticks
+static int32_t wheel_units(fix16_t ticks, int32_t multiplier) { return fix16_to_int(ticks * multiplier); }
+
+// Takes at most one report worth of wheel units out of ticks
+static int8_t take_wheel_units(fix16_t *ticks, int32_t multiplier) {
+    int8_t units = CLAMP(wheel_units(*ticks, multiplier), INT8_MIN, INT8_MAX);
+    *ticks -= units * FIX16_ONE / multiplier;
+    return units;
+}
+
+static bool has_pending_scroll(struct report_scheduler_data *data) {
+    return wheel_units(data->horizontal, report_scheduler_wheel_multiplier(INPUT_REL_HWHEEL)) ||
+           wheel_units(data->vertical, report_scheduler_wheel_multiplier(INPUT_REL_WHEEL));
+}
+
+#else
+
+static bool has_pending_scroll(struct report_scheduler_data *data) { return data->horizontal || data->vertical; }
+
+#endif
+
+static bool has_pending_output(struct report_scheduler_data *data) {
+    return data->x || data->y || has_pending_scroll(data) || data->button_edges_len || pending_zoom(data);
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+// Applications zoom on ctrl + wheel. The modifier is counted by ZMK, so a ctrl the user holds
+// stays pressed.
+static void send_zoom(int8_t zoom) {
+    zmk_hid_register_mods(MOD_LCTL);
+    zmk_endpoints_send_report(HID_USAGE_KEY);
+
+    zmk_hid_mouse_scroll_set(0, zoom);
+    zmk_endpoints_send_mouse_report();
+    zmk_hid_mouse_scroll_set(0, 0);
+
+    zmk_hid_unregister_mods(MOD_LCTL);
+    zmk_endpoints_send_report(HID_USAGE_KEY);
+}
+#endif
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_SPLIT_PERIPHERAL)
+
+// The central sends the reports, so the output crosses the split link as a few input events of the
+// gestures node instead of every raw position of the touchpad.
+static void send_report(const struct device *dev, bool has_button_edge, uint8_t button_edge, int16_t x, int16_t y,
+                        int8_t horizontal, int8_t vertical) {
+    struct input_event events[5];
+    uint8_t len = 0;
+
+    if (has_button_edge) {
+        events[len++] = (struct input_event){.type = INPUT_EV_KEY,
+                                             .code = INPUT_BTN_0 + BUTTON_EDGE_BUTTON(button_edge),
+                                             .value = (button_edge & BUTTON_EDGE_PRESSED) ? 1 : 0};
+    }
+    if (x) {
+        events[len++] = (struct input_event){.type = INPUT_EV_REL, .code = INPUT_REL_X, .value = x};
+    }
+    if (y) {
+        events[len++] = (struct input_event){.type = INPUT_EV_REL, .code = INPUT_REL_Y, .value = y};
+    }
+    if (horizontal) {
+        events[len++] = (struct input_event){.type = INPUT_EV_REL, .code = INPUT_REL_HWHEEL, .value = horizontal};
+    }
+    if (vertical) {
+        events[len++] = (struct input_event){.type = INPUT_EV_REL, .code = INPUT_REL_WHEEL, .value = vertical};
+    }
+
+    // the last event ends the frame, so the central sends all of them in one report
+    for (uint8_t i = 0; i < len; i++) {
+        input_report(dev, events[i].type, events[i].code, events[i].value, i == len - 1, K_FOREVER);
+    }
+}
+
+#else
+
+static void send_report(const struct device *dev, bool has_button_edge, uint8_t button_edge, int16_t x, int16_t y,
+                        int8_t horizontal, int8_t vertical) {
+    if (has_button_edge) {
+        if (button_edge & BUTTON_EDGE_PRESSED) {
+            zmk_hid_mouse_button_press(BUTTON_EDGE_BUTTON(button_edge));
+        } else {
+            zmk_hid_mouse_button_release(BUTTON_EDGE_BUTTON(button_edge));
+        }
+    }
+
+    zmk_hid_mouse_movement_set(x, y);
+    zmk_hid_mouse_scroll_set(horizontal, vertical);
+    zmk_endpoints_send_mouse_report();
+    zmk_hid_mouse_movement_set(0, 0);
+    zmk_hid_mouse_scroll_set(0, 0);
+}
+
+#endif
+
+// Must be called with the lock held
+static void schedule_flush(struct report_scheduler_data *data) {
+    uint32_t since_last_flush = gestures_uptime_get() - data->last_flush_timestamp;
+    uint32_t delay = 0;
+
+    if (since_last_flush < CONFIG_INPUT_GESTURES_REPORT_INTERVAL_MS) {
+        delay = CONFIG_INPUT_GESTURES_REPORT_INTERVAL_MS - since_last_flush;
+    }
+
+    // doesn't move an already scheduled flush, so everything until then gets merged into it
+    gestures_work_schedule(&data->flush_work, K_MSEC(delay));
+}
+
+static void report_scheduler_flush(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct report_scheduler_data *data = CONTAINER_OF(d_work, struct report_scheduler_data, flush_work);
+    uint32_t started = gesture_stats_start();
+
+    gesture_stats_count(data->all->dev, GESTURE_STATS_WAKEUPS);
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    if (!has_pending_output(data)) {
+        k_spin_unlock(&data->lock, key);
+        gesture_stats_stop(data->all->dev, GESTURE_STATS_REPORT, started);
+        return;
+    }
+
+    int16_t x = CLAMP(data->x, INT16_MIN, INT16_MAX);
+    int16_t y = CLAMP(data->y, INT16_MIN, INT16_MAX);
+    data->x -= x;
+    data->y -= y;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+    int8_t horizontal = take_wheel_units(&data->horizontal, report_scheduler_wheel_multiplier(INPUT_REL_HWHEEL));
+    int8_t vertical = take_wheel_units(&data->vertical, report_scheduler_wheel_multiplier(INPUT_REL_WHEEL));
+#else
+    int8_t horizontal = CLAMP(data->horizontal, INT8_MIN, INT8_MAX);
+    int8_t vertical = CLAMP(data->vertical, INT8_MIN, INT8_MAX);
+    data->horizontal -= horizontal;
+    data->vertical -= vertical;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    int8_t zoom = CLAMP(data->zoom, INT8_MIN, INT8_MAX);
+    data->zoom -= zoom;
+#endif
+
+    bool has_button_edge = data->button_edges_len > 0;
+    uint8_t button_edge = data->button_edges[0];
+    if (has_button_edge) {
+        data->button_edges_len--;
+        memmove(&data->button_edges[0], &data->button_edges[1], data->button_edges_len);
+    }
+
+    data->last_flush_timestamp = gestures_uptime_get();
+    if (has_pending_output(data)) {
+        schedule_flush(data);
+    }
+
+    k_spin_unlock(&data->lock, key);
+
+    if (has_button_edge || x || y || horizontal || vertical) {
+        trace_replay_note_report();
+        send_report(data->all->dev, has_button_edge, button_edge, x, y, horizontal, vertical);
+        gesture_stats_count(data->all->dev, GESTURE_STATS_REPORTS);
+    }
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    if (zoom != 0) {
+        trace_replay_note_report();
+        send_zoom(zoom);
+        gesture_stats_count(data->all->dev, GESTURE_STATS_REPORTS);
+    }
+#endif
+
+    gesture_stats_stop(data->all->dev, GESTURE_STATS_REPORT, started);
+}
+
+void report_scheduler_move(const struct device *dev, int32_t x, int32_t y) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->report_scheduler.lock);
+    data->report_scheduler.x += x;
+    data->report_scheduler.y += y;
+    schedule_flush(&data->report_scheduler);
+    k_spin_unlock(&data->report_scheduler.lock, key);
+}
+
+void report_scheduler_scroll(const struct device *dev, int32_t horizontal, int32_t vertical) {
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+    report_scheduler_scroll_fine(dev, fix16_from_int(horizontal), fix16_from_int(vertical));
+#else
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->report_scheduler.lock);
+    data->report_scheduler.horizontal += horizontal;
+    data->report_scheduler.vertical += vertical;
+    schedule_flush(&data->report_scheduler);
+    k_spin_unlock(&data->report_scheduler.lock, key);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+void report_scheduler_scroll_fine(const struct device *dev, fix16_t horizontal, fix16_t vertical) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->report_scheduler.lock);
+    data->report_scheduler.horizontal += horizontal;
+    data->report_scheduler.vertical += vertical;
+    // fractions below one unit of the wheel wait for the next scroll
+    if (has_pending_scroll(&data->report_scheduler)) {
+        schedule_flush(&data->report_scheduler);
+    }
+    k_spin_unlock(&data->report_scheduler.lock, key);
+}
+#endif
+
+void report_scheduler_button(const struct device *dev, uint8_t button, bool pressed) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->report_scheduler.lock);
+    if (data->report_scheduler.button_edges_len < REPORT_SCHEDULER_MAX_BUTTON_EDGES) {
+        data->report_scheduler.button_edges[data->report_scheduler.button_edges_len++] =
+            button | (pressed ? BUTTON_EDGE_PRESSED : 0);
+        schedule_flush(&data->report_scheduler);
+    } else {
+        LOG_WRN("too many button changes in flight, dropping one");
+    }
+    k_spin_unlock(&data->report_scheduler.lock, key);
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+void report_scheduler_zoom(const struct device *dev, int32_t ticks) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->report_scheduler.lock);
+    data->report_scheduler.zoom += ticks;
+    schedule_flush(&data->report_scheduler);
+    k_spin_unlock(&data->report_scheduler.lock, key);
+}
+#endif
+
+int report_scheduler_init(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    LOG_DBG("report_scheduler: at most one report every %d ms", CONFIG_INPUT_GESTURES_REPORT_INTERVAL_MS);
+
+    data->report_scheduler.last_flush_timestamp = gestures_uptime_get() - CONFIG_INPUT_GESTURES_REPORT_INTERVAL_MS;
+    k_work_init_delayable(&data->report_scheduler.flush_work, report_scheduler_flush);
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "input_processor_gestures.h"
+
+#define REPORT_SCHEDULER_MAX_BUTTON_EDGES 8
+
+// Collects the output of all gestures and sends at most one mouse report per
+// CONFIG_INPUT_GESTURES_REPORT_INTERVAL_MS. Movement and scrolling get merged,
+// button edges are sent in order, one per report.
+struct report_scheduler_data {
+    struct k_work_delayable flush_work;
+    struct k_spinlock lock;
+    int32_t x, y;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+    // in fractions of a tick, the part the resolution multiplier of the host resolves gets sent
+    fix16_t horizontal, vertical;
+#else
+    int32_t horizontal, vertical;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+    // scrolled with ctrl held, in a report of its own
+    int32_t zoom;
+#endif
+    uint8_t button_edges[REPORT_SCHEDULER_MAX_BUTTON_EDGES];
+    uint8_t button_edges_len;
+    uint32_t last_flush_timestamp;
+    gesture_data *all;
+};
+
+handle_init_t report_scheduler_init;
+
+// x and y are already in HID orientation
+void report_scheduler_move(const struct device *dev, int32_t x, int32_t y);
+void report_scheduler_scroll(const struct device *dev, int32_t horizontal, int32_t vertical);
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_HIRES_SCROLL)
+// horizontal and vertical are in ticks, fractions of a tick get sent to hosts with a resolution
+// multiplier and are kept until they add up to a whole tick for the others
+void report_scheduler_scroll_fine(const struct device *dev, fix16_t horizontal, fix16_t vertical);
+// Units of the wheel per tick, as set by the host for code INPUT_REL_WHEEL or INPUT_REL_HWHEEL
+int32_t report_scheduler_wheel_multiplier(uint16_t code);
+#endif
+void report_scheduler_button(const struct device *dev, uint8_t button, bool pressed);
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_PINCH_ZOOM)
+// positive values zoom in
+void report_scheduler_zoom(const struct device *dev, int32_t ticks);
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// A compact copy of an input event, timestamped when it arrived.
+struct gesture_sample {
+    uint32_t timestamp;
+    int32_t value;
+    uint16_t code;
+    uint8_t type;
+    uint8_t sync;
+};
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+
+#define SAMPLE_RING_SIZE CONFIG_INPUT_GESTURES_SAMPLE_RING_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(SAMPLE_RING_SIZE), "the sample ring size must be a power of two");
+
+// Lock-free single-producer/single-consumer ring: only the input path puts,
+// only the gesture thread gets. head and tail are free running counters.
+struct sample_ring {
+    atomic_t head;
+    atomic_t tail;
+    struct gesture_sample samples[SAMPLE_RING_SIZE];
+};
+
+static inline bool sample_ring_put(struct sample_ring *ring, const struct gesture_sample *sample) {
+    atomic_val_t head = atomic_get(&ring->head);
+
+    if (head - atomic_get(&ring->tail) >= SAMPLE_RING_SIZE) {
+        return false;
+    }
+
+    ring->samples[head & (SAMPLE_RING_SIZE - 1)] = *sample;
+    atomic_set(&ring->head, head + 1);
+    return true;
+}
+
+static inline bool sample_ring_get(struct sample_ring *ring, struct gesture_sample *sample) {
+    atomic_val_t tail = atomic_get(&ring->tail);
+
+    if (tail == atomic_get(&ring->head)) {
+        return false;
+    }
+
+    *sample = ring->samples[tail & (SAMPLE_RING_SIZE - 1)];
+    atomic_set(&ring->tail, tail + 1);
+    return true;
+}
+
+#endif
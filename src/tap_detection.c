@@ -6,88 +6,129 @@
 
  #include <drivers/input_processor.h>
  #include <zephyr/logging/log.h>
- #include <zmk/endpoints.h>
- #include <zmk/hid.h>
  #include "input_processor_gestures.h"
  
  LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
- 
- int tap_detection_handle_start(const struct device *dev, struct gesture_event_t *event) {
+
+ // Taps are decided when the touch ends, so a tap is clicked as soon as the end of the touch is
+ // detected instead of after tap_timout_ms. A touch that starts within tap_drag_window_ms after a
+ // tap presses the button right away and holds it until the touch ends: a short one completes a
+ // double click, a longer one drags.
+
+ static bool tap_detection_is_short(const struct device *dev, uint32_t timestamp) {
      struct gesture_config *config = (struct gesture_config *)dev->config;
      struct gesture_data *data = (struct gesture_data *)dev->data;
- 
-     if (! config->tap_detection.enabled) {
-         return -1;
+
+     return timestamp - data->tap_detection.touch_start_timestamp <= config->tap_detection.tap_timout_ms;
+ }
+
+ static int tap_detection_handle_start(const struct device *dev, struct gesture_event_t *event) {
+     struct gesture_config *config = (struct gesture_config *)dev->config;
+     struct gesture_data *data = (struct gesture_data *)dev->data;
+     uint32_t now = event->last_touch_timestamp;
+
+     data->tap_detection.touch_start_timestamp = now;
+
+     if (config->tap_detection.tap_drag && data->tap_detection.has_tap &&
+         now - data->tap_detection.tap_timestamp <= config->tap_detection.tap_drag_window_ms) {
+         LOG_DBG("touch right after a tap - holding the button");
+         data->tap_detection.state = TAP_DETECTION_DRAGGING;
+         data->tap_detection.has_tap = false;
+         trace_replay_note_decision(TRACE_REPLAY_TAP_DRAG);
+         report_scheduler_button(dev, 0, true);
+         return 0;
      }
- 
-     k_work_reschedule(&data->tap_detection.tap_timeout_work, K_MSEC(config->tap_detection.tap_timout_ms));
-     data->tap_detection.is_waiting_for_tap = true;
- 
+
+     data->tap_detection.state = TAP_DETECTION_TOUCHING;
      if (config->tap_detection.prevent_movement_during_tap) {
-         event->raw_event_1->code = 0;
-         event->raw_event_1->type = 0;
-         event->raw_event_1->value = 0;
- 
-         event->raw_event_2->code = 0;
-         event->raw_event_2->type = 0;
-         event->raw_event_2->value = 0;
+         atomic_set_bit(&data->raw_event_claims, GESTURE_CLAIM_TAP);
+         gestures_drop_raw_events(event);
      }
- 
+
      return 0;
  }
- 
- int tap_detection_handle_touch(const struct device *dev, struct gesture_event_t *event) {
+
+ static int tap_detection_handle_touch(const struct device *dev, struct gesture_event_t *event) {
      struct gesture_config *config = (struct gesture_config *)dev->config;
      struct gesture_data *data = (struct gesture_data *)dev->data;
- 
-     if (! config->tap_detection.enabled) {
-         return -1;
+
+     if (data->tap_detection.state != TAP_DETECTION_TOUCHING || !config->tap_detection.prevent_movement_during_tap) {
+         return 0;
      }
- 
-     if (data->tap_detection.is_waiting_for_tap && config->tap_detection.prevent_movement_during_tap) {
-         event->raw_event_1->code = 0;
-         event->raw_event_1->type = 0;
-         event->raw_event_1->value = 0;
- 
-         event->raw_event_2->code = 0;
-         event->raw_event_2->type = 0;
-         event->raw_event_2->value = 0;
+
+     if (tap_detection_is_short(dev, event->last_touch_timestamp)) {
+         gestures_drop_raw_events(event);
+     } else {
+         // too long for a tap, so it's a regular movement from now on
+         atomic_clear_bit(&data->raw_event_claims, GESTURE_CLAIM_TAP);
      }
- 
+
      return 0;
  }
- 
- 
- /* Work Queue Callback */
- static void tap_timeout_callback(struct k_work *work) {
-     struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-     struct tap_detection_data *data = CONTAINER_OF(d_work, struct tap_detection_data, tap_timeout_work);
-     data->is_waiting_for_tap = false;
-     if (!data->all->touch_detection.touching) {
-         LOG_DBG("tap detected - sending button presses");
-         zmk_hid_mouse_button_press(0);
-         zmk_endpoints_send_mouse_report();
-         zmk_hid_mouse_button_release(0);
-         zmk_endpoints_send_mouse_report();
-     } else {
-         LOG_DBG("time expired but touch is ongoing - it's not a tap");
+
+ static int tap_detection_handle_end(const struct device *dev) {
+     struct gesture_data *data = (struct gesture_data *)dev->data;
+     // the touch really ended with its last position, not when that was noticed
+     uint32_t end = data->touch_detection.last_touch_timestamp;
+
+     switch (data->tap_detection.state) {
+     case TAP_DETECTION_TOUCHING:
+         atomic_clear_bit(&data->raw_event_claims, GESTURE_CLAIM_TAP);
+         if (tap_detection_is_short(dev, end)) {
+             LOG_DBG("tap detected - sending button presses");
+             trace_replay_note_decision(TRACE_REPLAY_TAP);
+             report_scheduler_button(dev, 0, true);
+             report_scheduler_button(dev, 0, false);
+             data->tap_detection.tap_timestamp = end;
+             data->tap_detection.has_tap = true;
+         } else {
+             LOG_DBG("touch took too long - it's not a tap");
+         }
+         break;
+     case TAP_DETECTION_DRAGGING:
+         LOG_DBG("%s ended - releasing the button", tap_detection_is_short(dev, end) ? "double tap" : "drag");
+         report_scheduler_button(dev, 0, false);
+         break;
+     default:
+         break;
      }
+
+     data->tap_detection.state = TAP_DETECTION_IDLE;
+     return 0;
  }
- 
- int tap_detection_init(const struct device *dev) {
-     struct gesture_config *config = (struct gesture_config *)dev->config;
+
+ static int tap_detection_handle_cancel(const struct device *dev) {
      struct gesture_data *data = (struct gesture_data *)dev->data;
- 
-     LOG_DBG("tap_detection: %s, timeout in ms: %d, prevent_movement_during_tap: %s", 
-         config->tap_detection.enabled ? "yes" : "no", 
-         config->tap_detection.tap_timout_ms,
-         config->tap_detection.prevent_movement_during_tap ? "yes" : "no");
- 
-     if (!config->tap_detection.enabled) {
-         return -1;
+
+     if (data->tap_detection.state == TAP_DETECTION_DRAGGING) {
+         report_scheduler_button(dev, 0, false);
      }
-     k_work_init_delayable(&data->tap_detection.tap_timeout_work, tap_timeout_callback);
- 
+     data->tap_detection.state = TAP_DETECTION_IDLE;
+     data->tap_detection.has_tap = false;
+     atomic_clear_bit(&data->raw_event_claims, GESTURE_CLAIM_TAP);
+     return 0;
+ }
+
+ static int tap_detection_init(const struct device *dev) {
+     struct gesture_config *config = (struct gesture_config *)dev->config;
+
+     LOG_DBG("tap_detection: timeout in ms: %d, prevent_movement_during_tap: %s, tap_drag: %s, window in ms: %d",
+         config->tap_detection.tap_timout_ms,
+         config->tap_detection.prevent_movement_during_tap ? "yes" : "no",
+         config->tap_detection.tap_drag ? "yes" : "no",
+         config->tap_detection.tap_drag_window_ms);
+
      return 0;
  }
- 
\ No newline at end of file
+
+ // Taps are short, so they are only recognized when no other gesture took over the touch
+ const struct gesture_recognizer tap_detection_recognizer = {
+     .name = "tap detection",
+     .priority = 20,
+     .stage = GESTURE_STATS_TAP_DETECTION,
+     .init = tap_detection_init,
+     .touch_start = tap_detection_handle_start,
+     .touch = tap_detection_handle_touch,
+     .touch_end = tap_detection_handle_end,
+     .cancel = tap_detection_handle_cancel,
+ };
@@ -8,19 +8,28 @@
 
 #include "input_processor_gestures.h"
 
+enum tap_detection_state {
+    TAP_DETECTION_IDLE,
+    // the touch is a tap if it ends within tap_timout_ms
+    TAP_DETECTION_TOUCHING,
+    // the touch started shortly after a tap, the button is held until it ends
+    TAP_DETECTION_DRAGGING,
+};
+
 struct tap_detection_data {
-    bool is_waiting_for_tap;
-    struct k_work_delayable tap_timeout_work;
+    enum tap_detection_state state;
+    uint32_t touch_start_timestamp;
+    // when the last tap ended, only valid if has_tap is set
+    uint32_t tap_timestamp;
+    bool has_tap;
     gesture_data *all;
 };
 
 struct tap_detection_config {
-    const bool enabled;
     const bool prevent_movement_during_tap;
     const uint8_t tap_timout_ms;
+    const bool tap_drag;
+    const uint16_t tap_drag_window_ms;
 };
 
-handle_init_t tap_detection_init;
-handle_touch_t tap_detection_handle_start;
-handle_touch_t tap_detection_handle_touch;
-
+extern const struct gesture_recognizer tap_detection_recognizer;
@@ -10,44 +10,224 @@
 
 LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
 
+static void touch_history_add(struct touch_detection_data *data, uint32_t timestamp) {
+    struct touch_history *history = &data->history;
+    int32_t x = data->absolute ? data->x : (int16_t)data->x;
+    int32_t y = data->absolute ? data->y : (int16_t)data->y;
 
-int touch_detection_handle_event(const struct device *dev, struct input_event *event, uint32_t param1,
-                               uint32_t param2, struct zmk_input_processor_state *state) {
-    struct gesture_config *config = (struct gesture_config *)dev->config;
+    if (!data->absolute && history->count > 0) {
+        x += history->x[history->newest];
+        y += history->y[history->newest];
+    }
+
+    history->newest = (history->newest + 1) & (TOUCH_HISTORY_SIZE - 1);
+    history->timestamp[history->newest] = timestamp;
+    history->x[history->newest] = x;
+    history->y[history->newest] = y;
+    history->count = MIN(history->count + 1, TOUCH_HISTORY_SIZE);
+}
+
+int touch_detection_velocity(const struct device *dev, uint32_t window_ms, fix16_t *velocity_x,
+                             fix16_t *velocity_y) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
-    k_work_reschedule(&data->touch_detection.touch_end_timeout_work, K_MSEC(config->touch_detection.wait_for_new_position_ms));
+    const struct touch_history *history = &data->touch_detection.history;
+    uint8_t newest = history->newest;
 
-    if (event->type != INPUT_EV_ABS && event->type == INPUT_EV_REL) {
-        return ZMK_INPUT_PROC_CONTINUE;
+    // least squares fit of position over time, relative to the newest position to keep the sums small
+    int32_t n = 0;
+    int64_t sum_t = 0, sum_tt = 0, sum_x = 0, sum_tx = 0, sum_y = 0, sum_ty = 0;
+
+    for (uint8_t i = 0; i < history->count; i++) {
+        uint8_t index = (newest - i) & (TOUCH_HISTORY_SIZE - 1);
+        int32_t t = history->timestamp[index] - history->timestamp[newest];
+        if (-t > (int32_t)window_ms) {
+            break;
+        }
+        int32_t x = history->x[index] - history->x[newest];
+        int32_t y = history->y[index] - history->y[newest];
+
+        n++;
+        sum_t += t;
+        sum_tt += (int64_t)t * t;
+        sum_x += x;
+        sum_tx += (int64_t)t * x;
+        sum_y += y;
+        sum_ty += (int64_t)t * y;
+    }
+
+    int64_t denominator = n * sum_tt - sum_t * sum_t;
+    if (n < 2 || denominator == 0) {
+        return -1;
     }
 
-    data->touch_detection.complete = !data->touch_detection.complete;
+    *velocity_x = (fix16_t)(((n * sum_tx - sum_t * sum_x) * FIX16_ONE) / denominator);
+    *velocity_y = (fix16_t)(((n * sum_ty - sum_t * sum_y) * FIX16_ONE) / denominator);
+    return 0;
+}
+
+
+static void touch_detection_end(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+    // the touchpad stopped reporting, so whatever contacts are left are gone as well
+    touch_slots_reset(&data->touch_detection.slots);
+    if (data->touch_detection.slots.changed) {
+        data->touch_detection.slots.changed = false;
+        gestures_frame(dev, &data->touch_detection.slots);
+    }
+#endif
+
+    data->touch_detection.touching = false;
+    data->touch_detection.pending_axes = 0;
+    trace_replay_note_decision(TRACE_REPLAY_TOUCH_END);
+    gestures_touch_end(dev);
+}
+
+// How long to wait for the next position before the touch is over, in ms
+static uint32_t touch_detection_end_timeout(const struct device *dev) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    const struct touch_detection_config *touch_config = &config->touch_detection;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    uint32_t interval = data->touch_detection.report_interval;
+
+    if (!touch_config->adaptive_touch_end || interval == 0) {
+        return touch_config->wait_for_new_position_ms;
+    }
+
+    uint32_t timeout_ms = DIV_ROUND_UP(interval * touch_config->adaptive_touch_end_percent / 100,
+                                       BIT(TOUCH_INTERVAL_SHIFT));
+    return CLAMP(timeout_ms, touch_config->adaptive_touch_end_min_ms, touch_config->wait_for_new_position_ms);
+}
+
+// Called for every event, but only touches the kernel timeout queue if the timer isn't running yet
+static void touch_detection_arm_end_timeout(const struct device *dev, uint32_t timestamp) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    data->touch_detection.last_event_timestamp = timestamp;
+    if (atomic_cas(&data->touch_detection.touch_end_timeout_armed, 0, 1)) {
+        gesture_stats_count(dev, GESTURE_STATS_TOUCH_END_TIMERS);
+        gestures_work_reschedule(&data->touch_detection.touch_end_timeout_work,
+                                 K_MSEC(touch_detection_end_timeout(dev)));
+    }
+}
+
+static void touch_detection_learn_interval(const struct device *dev, uint32_t delta_time) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    uint32_t *interval = &data->touch_detection.report_interval;
+
+    // a pause this long only happens between touches
+    if (delta_time > config->touch_detection.wait_for_new_position_ms) {
+        return;
+    }
+
+    int32_t measured = delta_time << TOUCH_INTERVAL_SHIFT;
+    if (*interval == 0) {
+        *interval = measured;
+    } else {
+        *interval += (measured - (int32_t)*interval) >> TOUCH_INTERVAL_WEIGHT_SHIFT;
+    }
+}
+
+uint32_t touch_detection_interval(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    return data->touch_detection.report_interval;
+}
+
+// Touchpads that report lifting the finger end the touch right away, instead of after the timeout.
+// Returns true for every event that only tells whether the finger is down.
+static bool touch_detection_handle_contact(const struct device *dev, const struct gesture_sample *sample) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    bool is_contact = (sample->type == INPUT_EV_KEY && sample->code == INPUT_BTN_TOUCH) ||
+                      (sample->type == INPUT_EV_ABS &&
+                       (sample->code == INPUT_ABS_PRESSURE || sample->code == INPUT_ABS_Z));
+
+    if (!is_contact) {
+        return false;
+    }
+
+    if (sample->value == 0 && data->touch_detection.touching) {
+        LOG_DBG("touchpad reports the end of the touch");
+        // a position in the same frame as the lift would start a new touch
+        data->touch_detection.pending_axes = 0;
+        k_work_cancel_delayable(&data->touch_detection.touch_end_timeout_work);
+        atomic_clear(&data->touch_detection.touch_end_timeout_armed);
+        touch_detection_end(dev);
+    }
+    return true;
+}
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+
+// Contacts are only looked at once all of their changes of a frame arrived
+static void touch_detection_end_frame(const struct device *dev, const struct gesture_sample *sample) {
+    struct touch_slots *slots = &((struct gesture_data *)dev->data)->touch_detection.slots;
+
+    if (sample->sync && slots->changed) {
+        slots->changed = false;
+        gestures_frame(dev, slots);
+    }
+}
+
+#endif
+
+// Keeps the coordinate of a position event for the end of its frame. Returns false for all other
+// events.
+static bool touch_detection_handle_axis(const struct device *dev, const struct gesture_sample *sample) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+    bool absolute = sample->type == INPUT_EV_ABS;
+    uint8_t axis;
+
+    if (absolute && sample->code == INPUT_ABS_X) {
+        axis = TOUCH_AXIS_X;
+    } else if (absolute && sample->code == INPUT_ABS_Y) {
+        axis = TOUCH_AXIS_Y;
+    } else if (sample->type == INPUT_EV_REL && sample->code == INPUT_REL_X) {
+        axis = TOUCH_AXIS_X;
+    } else if (sample->type == INPUT_EV_REL && sample->code == INPUT_REL_Y) {
+        axis = TOUCH_AXIS_Y;
+    } else {
+        return false;
+    }
 
-    if (data->touch_detection.complete && data->touch_detection.absolute != (event->type == INPUT_EV_ABS)) {
-        LOG_ERR("Surprising change of absolute/relative type. It's now [%s] but it's supposed to be [%s]. Don't know how to handle that, so ignoring this", 
-            event->type == INPUT_EV_ABS ? "absolute" : "relative",
+    if (data->touch_detection.touching && data->touch_detection.absolute != absolute) {
+        LOG_ERR("Surprising change of absolute/relative type. It's now [%s] but it's supposed to be [%s]. Don't know how to handle that, so ignoring this",
+            absolute ? "absolute" : "relative",
             data->touch_detection.absolute ? "absolute" : "relative"
         );
-        return ZMK_INPUT_PROC_CONTINUE;
-    } else {
-        data->touch_detection.absolute = (event->type == INPUT_EV_ABS);
+        return true;
     }
 
+    if (data->touch_detection.absolute != absolute) {
+        data->touch_detection.absolute = absolute;
+        data->touch_detection.pending_axes = 0;
+    }
 
-    if (event->code == INPUT_ABS_X || event->code == INPUT_REL_X) {
-        data->touch_detection.x = event->value;
-    } else if (event->code == INPUT_ABS_Y || event->code == INPUT_REL_Y) {
-        data->touch_detection.y = event->value;
+    if (!absolute && data->touch_detection.pending_axes == 0) {
+        // a relative frame only reports the axes that moved
+        data->touch_detection.x = 0;
+        data->touch_detection.y = 0;
     }
 
-    if (! data->touch_detection.complete) {
-        // is this true? 
-        // because sometimes we might not want to forward half the events!
-        // for example when waiting during a tap or while a scroll is happening
-        return ZMK_INPUT_PROC_CONTINUE;
+    if (axis == TOUCH_AXIS_X) {
+        data->touch_detection.x = sample->value;
+    } else {
+        data->touch_detection.y = sample->value;
     }
+    data->touch_detection.pending_axes |= axis;
 
-    uint32_t now = k_uptime_get();
+    if (!sample->sync) {
+        gesture_stats_count(dev, GESTURE_STATS_HALF_EVENTS);
+    }
+    return true;
+}
+
+// The frame is over, so its position goes to the recognizers
+static void touch_detection_dispatch(const struct device *dev, uint32_t now, struct input_event *raw_event) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    data->touch_detection.pending_axes = 0;
 
     struct gesture_event_t gesture_event = {
         .last_touch_timestamp = now,
@@ -60,22 +240,134 @@ int touch_detection_handle_event(const struct device *dev, struct input_event *e
         .delta_y = data->touch_detection.y - data->touch_detection.previous_y,
         .delta_time = now - data->touch_detection.last_touch_timestamp,
         .absolute = data->touch_detection.absolute,
-        .raw_event_1 = data->touch_detection.previous_event,
-        .raw_event_2 = event
+        .raw_event = raw_event,
     };
 
     data->touch_detection.last_touch_timestamp = now;
 
+    if (!data->touch_detection.touching){
+        data->touch_detection.history.count = 0;
+    } else {
+        touch_detection_learn_interval(dev, gesture_event.delta_time);
+    }
+    touch_history_add(&data->touch_detection, now);
+
     if (!data->touch_detection.touching){
         data->touch_detection.touching = true;
-        config->handle_touch_start(dev, &gesture_event);
+        trace_replay_note_decision(TRACE_REPLAY_TOUCH_START);
+        gesture_stats_count(dev, GESTURE_STATS_TOUCHES);
+        gestures_touch_start(dev, &gesture_event);
     } else {
-        config->handle_touch_continue(dev, &gesture_event);
+        gestures_touch(dev, &gesture_event);
     }
 
     data->touch_detection.previous_x = data->touch_detection.x;
     data->touch_detection.previous_y = data->touch_detection.y;
+}
+
+static void touch_detection_process(const struct device *dev, const struct gesture_sample *sample,
+                                   struct input_event *raw_event) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    if (!touch_detection_handle_contact(dev, sample)) {
+        touch_detection_arm_end_timeout(dev, sample->timestamp);
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+        if (!touch_slots_handle_event(&data->touch_detection.slots, sample->type, sample->code, sample->value)) {
+            touch_detection_handle_axis(dev, sample);
+        }
+        touch_detection_end_frame(dev, sample);
+#else
+        touch_detection_handle_axis(dev, sample);
+#endif
+    }
+
+    // whatever event ends the frame, its position is complete now
+    if (sample->sync && data->touch_detection.pending_axes != 0) {
+        touch_detection_dispatch(dev, sample->timestamp, raw_event);
+    }
+}
 
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+
+static void touch_detection_sample_work_handler(struct k_work *work) {
+    struct touch_detection_data *data = CONTAINER_OF(work, struct touch_detection_data, sample_work);
+    struct gesture_sample sample;
+
+    while (sample_ring_get(&data->samples, &sample)) {
+        touch_detection_process(data->all->dev, &sample, NULL);
+    }
+}
+
+#endif
+
+// The recognizers only see the event that ends a frame, and in the gesture thread not even that,
+// so drop the raw positions here as long as a recognizer claims them. The events of a frame can't
+// be held back, so when a claim starts with the event that ends a frame, the other axis of that
+// frame has already gone on: every claim starts after at most one axis of one stray movement.
+static void touch_detection_apply_claims(struct gesture_data *data, struct input_event *event) {
+    if (atomic_get(&data->raw_event_claims) == 0) {
+        return;
+    }
+
+    if (event->type == INPUT_EV_ABS || event->type == INPUT_EV_REL) {
+        event->code = 0;
+        event->type = 0;
+        event->value = 0;
+    }
+}
+
+int touch_detection_handle_event(const struct device *dev, struct input_event *event, uint32_t param1,
+                               uint32_t param2, struct zmk_input_processor_state *state) {
+    const struct gesture_config *config = (const struct gesture_config *)dev->config;
+
+    if (config->sensor != NULL && event->dev != config->sensor) {
+        // belongs to another touchpad with its own gestures
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    uint32_t started = gesture_stats_start();
+    gesture_stats_count(dev, GESTURE_STATS_EVENTS);
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TRACE_RECORD)
+    LOG_INF("trace: %u %u %u %d %u", gestures_uptime_get(), event->type, event->code, event->value, event->sync);
+#endif
+    latency_trace_event(event);
+    jitter_filter_event(dev, event, gestures_uptime_get());
+
+    struct gesture_sample sample = {
+        .timestamp = gestures_uptime_get(),
+        .value = event->value,
+        .code = event->code,
+        .type = event->type,
+        .sync = event->sync,
+    };
+
+    // the gestures see where the finger is, the input processors after them the accelerated movement
+    acceleration_event(dev, event, sample.timestamp);
+    pointer_prediction_event(dev, event, sample.timestamp);
+
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+    if (!sample_ring_put(&data->touch_detection.samples, &sample)) {
+        LOG_WRN("gesture thread is falling behind, dropping event");
+        gesture_stats_count(dev, GESTURE_STATS_RING_OVERFLOWS);
+    }
+    gestures_work_submit(&data->touch_detection.sample_work);
+    touch_detection_apply_claims(data, event);
+#else
+    // before the recognizers run, so that they can still turn the event into a scroll
+    touch_detection_apply_claims(data, event);
+    touch_detection_process(dev, &sample, event);
+#endif
+
+    gesture_stats_stop(dev, GESTURE_STATS_INPUT, started);
+
+    // on a split peripheral, claimed events don't have to cross the split link at all
+    if (IS_ENABLED(CONFIG_INPUT_GESTURES_SPLIT_PERIPHERAL) && event->type == 0) {
+        return ZMK_INPUT_PROC_STOP;
+    }
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
@@ -83,17 +375,26 @@ void touch_end_timeout_callback(struct k_work *work) {
     struct k_work_delayable *d_work = k_work_delayable_from_work(work);
     struct touch_detection_data *data = CONTAINER_OF(d_work, struct touch_detection_data, touch_end_timeout_work);
     const struct device *dev = data->all->dev;
-    struct gesture_config *config = (struct gesture_config *)dev->config;
-    
-    data->touching = false;
-    data->complete = true;
-    config->handle_touch_end(dev);
+    uint32_t timeout = touch_detection_end_timeout(dev);
+    uint32_t elapsed = gestures_uptime_get() - data->last_event_timestamp;
+
+    gesture_stats_count(dev, GESTURE_STATS_WAKEUPS);
+    if (elapsed < timeout) {
+        // events arrived while the timer was running, so wait for the rest of the timeout
+        gestures_work_reschedule(d_work, K_MSEC(timeout - elapsed));
+        return;
+    }
+
+    atomic_clear(&data->touch_end_timeout_armed);
+    touch_detection_end(dev);
 }
 
 int touch_detection_init(const struct device *dev) {
     struct gesture_data *data = (struct gesture_data *)dev->data;
-    data->touch_detection.last_touch_timestamp = k_uptime_get();
-    data->touch_detection.complete = true;
+    data->touch_detection.last_touch_timestamp = gestures_uptime_get();
     k_work_init_delayable(&data->touch_detection.touch_end_timeout_work, touch_end_timeout_callback);
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+    k_work_init(&data->touch_detection.sample_work, touch_detection_sample_work_handler);
+#endif
     return 0;
 }
@@ -7,22 +7,86 @@
 #pragma once
 
 #include "input_processor_gestures.h"
+#include "sample_ring.h"
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+#include "touch_slots.h"
+#endif
+#include "gesture_math.h"
+#include "jitter_filter.h"
+
+#define TOUCH_HISTORY_SIZE CONFIG_INPUT_GESTURES_TOUCH_HISTORY_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(TOUCH_HISTORY_SIZE), "the touch history size must be a power of two");
+
+// The most recent positions of the ongoing touch. In relative mode, the
+// positions are the sum of all movements since the touch started.
+struct touch_history {
+    uint32_t timestamp[TOUCH_HISTORY_SIZE];
+    int32_t x[TOUCH_HISTORY_SIZE];
+    int32_t y[TOUCH_HISTORY_SIZE];
+    uint8_t newest;
+    uint8_t count;
+};
+
+// The learned time between two positions is kept with this many fractional bits
+#define TOUCH_INTERVAL_SHIFT 8
+// Each new interval moves the learned one by 1/2^TOUCH_INTERVAL_WEIGHT_SHIFT of the difference
+#define TOUCH_INTERVAL_WEIGHT_SHIFT 3
+
+// One frame of the sensor, up to the event with sync set, becomes one position. Axes that
+// didn't change aren't reported by every sensor.
+#define TOUCH_AXIS_X BIT(0)
+#define TOUCH_AXIS_Y BIT(1)
 
 struct touch_detection_data {
     bool touching;
+    // armed once per touch, it only ends the touch if no event arrived since last_event_timestamp
+    // for the timeout, otherwise it waits for the rest of the timeout
     struct k_work_delayable touch_end_timeout_work;
+    atomic_t touch_end_timeout_armed;
+    uint32_t last_event_timestamp;
     uint32_t last_touch_timestamp;
+    // moving average of the time between two positions in ms << TOUCH_INTERVAL_SHIFT, 0 until
+    // the first interval was measured. Read from the input path, so it's only ever written whole.
+    uint32_t report_interval;
     uint16_t x, y, previous_x, previous_y;
     bool absolute;
-    bool complete;
-    struct input_event *previous_event;
+    // TOUCH_AXIS_X and TOUCH_AXIS_Y of the frame that hasn't ended yet
+    uint8_t pending_axes;
+    struct touch_history history;
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_MULTI_TOUCH)
+    struct touch_slots slots;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_JITTER_FILTER)
+    // runs on the input path even with the gesture thread, so it can fix the raw events
+    struct jitter_filter_data jitter_filter;
+#endif
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_THREAD)
+    struct sample_ring samples;
+    struct k_work sample_work;
+#endif
     gesture_data *all;
 };
 
 struct touch_detection_config {
     const uint8_t wait_for_new_position_ms;
+    // the touch ends after adaptive_touch_end_percent of the learned report interval, but not
+    // before adaptive_touch_end_min_ms and not after wait_for_new_position_ms
+    const bool adaptive_touch_end;
+    const uint8_t adaptive_touch_end_min_ms;
+    const uint16_t adaptive_touch_end_percent;
 };
 
 handle_init_t touch_detection_init;
+
+// Velocity of the ongoing touch in pixels per ms, fitted through the positions of the last
+// window_ms. Returns -1 if there aren't at least two positions in that window.
+int touch_detection_velocity(const struct device *dev, uint32_t window_ms, fix16_t *velocity_x,
+                             fix16_t *velocity_y);
+
+// The learned time between two positions of the touchpad in ms << TOUCH_INTERVAL_SHIFT, 0 until
+// the first interval was measured
+uint32_t touch_detection_interval(const struct device *dev);
+
 int touch_detection_handle_event(const struct device *dev, struct input_event *event, uint32_t param1,
                                uint32_t param2, struct zmk_input_processor_state *state);
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include "touch_slots.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+bool touch_slots_handle_event(struct touch_slots *slots, uint16_t type, uint16_t code, int32_t value) {
+    if (type != INPUT_EV_ABS) {
+        return false;
+    }
+
+    switch (code) {
+    case INPUT_ABS_MT_SLOT:
+        if (value < 0 || value >= TOUCH_SLOTS) {
+            // once per touch, not at the rate of the sensor
+            if (!slots->has_warned) {
+                LOG_WRN("ignoring contact in slot %d, only %d slots are tracked", value, TOUCH_SLOTS);
+                slots->has_warned = true;
+            }
+            value = TOUCH_SLOTS;
+        }
+        slots->current = value;
+        return true;
+    case INPUT_ABS_MT_TRACKING_ID:
+        if (slots->current < TOUCH_SLOTS) {
+            // a tracking id of -1 lifts the contact, any other starts a new one
+            WRITE_BIT(slots->contacts, slots->current, value >= 0);
+            slots->changed = true;
+        }
+        return true;
+    case INPUT_ABS_MT_POSITION_X:
+    case INPUT_ABS_MT_POSITION_Y:
+        if (slots->current < TOUCH_SLOTS) {
+            if (code == INPUT_ABS_MT_POSITION_X) {
+                slots->x[slots->current] = value;
+            } else {
+                slots->y[slots->current] = value;
+            }
+            // not every touchpad sends tracking ids
+            slots->contacts |= BIT(slots->current);
+            slots->changed = true;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+void touch_slots_reset(struct touch_slots *slots) {
+    slots->changed = slots->contacts != 0;
+    slots->contacts = 0;
+    slots->has_warned = false;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#define TOUCH_SLOTS CONFIG_INPUT_GESTURES_TOUCH_SLOTS
+
+BUILD_ASSERT(TOUCH_SLOTS <= 32, "the contacts of all slots must fit into a 32 bit mask");
+
+// The contacts of a multi-touch touchpad, indexed by ABS_MT_SLOT. Kept as separate arrays, so the
+// table takes 4 bytes per slot plus a few bytes of bookkeeping.
+struct touch_slots {
+    uint16_t x[TOUCH_SLOTS];
+    uint16_t y[TOUCH_SLOTS];
+    // bit i is set while slot i has a contact
+    uint32_t contacts;
+    // the slot that the next ABS_MT event belongs to, TOUCH_SLOTS for a slot that isn't tracked
+    uint8_t current;
+    // contacts or positions changed since the last frame
+    bool changed;
+    // an untracked slot was already logged during this touch
+    bool has_warned;
+};
+
+// Updates the table with an ABS_MT event. Returns false for all other events.
+bool touch_slots_handle_event(struct touch_slots *slots, uint16_t type, uint16_t code, int32_t value);
+
+// Lifts all contacts
+void touch_slots_reset(struct touch_slots *slots);
+
+static inline uint8_t touch_slots_count(const struct touch_slots *slots) {
+    return __builtin_popcount(slots->contacts);
+}
+
+// The contacts in the two lowest slots, needs at least two contacts
+static inline void touch_slots_first_two(const struct touch_slots *slots, uint8_t *first, uint8_t *second) {
+    *first = __builtin_ctz(slots->contacts);
+    *second = __builtin_ctz(slots->contacts & (slots->contacts - 1));
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include "touch_zones.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+// (dx / half_width)^2 + (dy / half_height)^2 <= 1, without divisions
+static bool is_inside_ellipse(int32_t dx, int32_t dy, uint16_t half_width, uint16_t half_height) {
+    uint64_t width_squared = (uint64_t)half_width * half_width;
+    uint64_t height_squared = (uint64_t)half_height * half_height;
+    return (uint64_t)((int64_t)dx * dx) * height_squared + (uint64_t)((int64_t)dy * dy) * width_squared <=
+           width_squared * height_squared;
+}
+
+static bool is_on_rim(const struct touch_zones *zones, int32_t x, int32_t y) {
+    int32_t dx = x - zones->half_width;
+    int32_t dy = y - zones->half_height;
+    return is_inside_ellipse(dx, dy, zones->half_width, zones->half_height) &&
+           !is_inside_ellipse(dx, dy, zones->inner_half_width, zones->inner_half_height);
+}
+
+static bool is_in_zone(const struct touch_zones *zones, enum touch_zone zone, int32_t x, int32_t y) {
+    switch (zone) {
+    case TOUCH_ZONE_RIM:
+        return is_on_rim(zones, x, y);
+    case TOUCH_ZONE_RIGHT:
+        return y >= zones->right_start;
+    case TOUCH_ZONE_TOP:
+        return x >= zones->top_start;
+    default:
+        return false;
+    }
+}
+
+// The first coordinate of a cell, so that coordinate * TOUCH_ZONES_GRID / size == cell
+static uint16_t cell_start(uint16_t cell, uint16_t size) {
+    return DIV_ROUND_UP((uint32_t)cell * size, TOUCH_ZONES_GRID);
+}
+
+// Zones that contain every position of the cell, and those that might contain some
+static uint8_t classify_cell(const struct touch_zones *zones, uint16_t x0, uint16_t x1, uint16_t y0,
+                             uint16_t y1) {
+    uint8_t full = 0, partial = 0;
+
+    if (zones->enabled & BIT(TOUCH_ZONE_RIM)) {
+        // the position closest to the center and the one farthest away from it
+        int32_t near_x = CLAMP(zones->half_width, x0, x1), near_y = CLAMP(zones->half_height, y0, y1);
+        int32_t far_x = abs(x0 - zones->half_width) > abs(x1 - zones->half_width) ? x0 : x1;
+        int32_t far_y = abs(y0 - zones->half_height) > abs(y1 - zones->half_height) ? y0 : y1;
+
+        if (is_on_rim(zones, near_x, near_y) && is_on_rim(zones, far_x, far_y)) {
+            full |= BIT(TOUCH_ZONE_RIM);
+        } else if (is_inside_ellipse(near_x - zones->half_width, near_y - zones->half_height,
+                                     zones->half_width, zones->half_height) &&
+                   !is_inside_ellipse(far_x - zones->half_width, far_y - zones->half_height,
+                                      zones->inner_half_width, zones->inner_half_height)) {
+            partial |= BIT(TOUCH_ZONE_RIM);
+        }
+    }
+
+    if (zones->enabled & BIT(TOUCH_ZONE_RIGHT)) {
+        if (y0 >= zones->right_start) {
+            full |= BIT(TOUCH_ZONE_RIGHT);
+        } else if (y1 >= zones->right_start) {
+            partial |= BIT(TOUCH_ZONE_RIGHT);
+        }
+    }
+
+    if (zones->enabled & BIT(TOUCH_ZONE_TOP)) {
+        if (x0 >= zones->top_start) {
+            full |= BIT(TOUCH_ZONE_TOP);
+        } else if (x1 >= zones->top_start) {
+            partial |= BIT(TOUCH_ZONE_TOP);
+        }
+    }
+
+    return full | (partial << TOUCH_ZONE_PARTIAL_SHIFT);
+}
+
+void touch_zones_init(struct touch_zones *zones, const struct touch_zones_config *config) {
+    // the rim has the same width on all sides, based on the average of width and height
+    uint16_t rim = (config->width + config->height) / 2 * config->rim_percent / 100;
+
+    zones->enabled = (config->rim_percent ? BIT(TOUCH_ZONE_RIM) : 0) |
+                     (config->right_percent ? BIT(TOUCH_ZONE_RIGHT) : 0) |
+                     (config->top_percent ? BIT(TOUCH_ZONE_TOP) : 0);
+    zones->width = MAX(config->width, 1);
+    zones->height = MAX(config->height, 1);
+    zones->half_width = config->width / 2;
+    zones->half_height = config->height / 2;
+    zones->inner_half_width = zones->half_width - MIN(rim, zones->half_width);
+    zones->inner_half_height = zones->half_height - MIN(rim, zones->half_height);
+    // in the orientation the gestures report in, the height of the touchpad goes from left to right
+    // and its width from the bottom up
+    zones->right_start = config->height - config->height * config->right_percent / 100;
+    zones->top_start = config->width - config->width * config->top_percent / 100;
+
+    LOG_DBG("touch zones: rim %d, right from y %d, top from x %d", rim, zones->right_start, zones->top_start);
+
+    for (uint16_t row = 0; row < TOUCH_ZONES_GRID; row++) {
+        uint16_t y0 = cell_start(row, zones->height);
+        uint16_t y1 = MAX(cell_start(row + 1, zones->height), y0 + 1) - 1;
+
+        for (uint16_t column = 0; column < TOUCH_ZONES_GRID; column++) {
+            uint16_t x0 = cell_start(column, zones->width);
+            uint16_t x1 = MAX(cell_start(column + 1, zones->width), x0 + 1) - 1;
+
+            zones->grid[row][column] = classify_cell(zones, x0, x1, y0, y1);
+        }
+    }
+}
+
+uint8_t touch_zones_classify(const struct touch_zones *zones, uint16_t x, uint16_t y) {
+    uint8_t cell;
+
+    if (x < zones->width && y < zones->height) {
+        cell = zones->grid[(uint32_t)y * TOUCH_ZONES_GRID / zones->height]
+                          [(uint32_t)x * TOUCH_ZONES_GRID / zones->width];
+    } else {
+        // outside of the configured size, so test all zones exactly
+        cell = zones->enabled << TOUCH_ZONE_PARTIAL_SHIFT;
+    }
+
+    uint8_t zones_of_position = cell & BIT_MASK(TOUCH_ZONE_PARTIAL_SHIFT);
+    uint8_t partial = cell >> TOUCH_ZONE_PARTIAL_SHIFT;
+
+    for (uint8_t zone = 0; partial != 0; zone++, partial >>= 1) {
+        if ((partial & 1) && is_in_zone(zones, zone, x, y)) {
+            zones_of_position |= BIT(zone);
+        }
+    }
+
+    return zones_of_position;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// Areas of the touchpad where a touch starts a special gesture. A position can be in several of
+// them, for example in the top right corner. Right and top are in the orientation the gestures
+// report in: the right side is at the end of the y axis of the touchpad, the top at the end of its
+// x axis.
+enum touch_zone {
+    // the ring along the border of the ellipse inscribed into the touchpad
+    TOUCH_ZONE_RIM,
+    TOUCH_ZONE_RIGHT,
+    TOUCH_ZONE_TOP,
+    TOUCH_ZONE_COUNT,
+};
+
+// The touchpad is divided into a grid of TOUCH_ZONES_GRID x TOUCH_ZONES_GRID cells. Each cell
+// knows the zones that cover it completely, and the zones whose border passes through it. Only
+// positions in the latter need an exact test.
+#define TOUCH_ZONES_GRID 16
+#define TOUCH_ZONE_PARTIAL_SHIFT 4
+
+BUILD_ASSERT(TOUCH_ZONE_COUNT <= TOUCH_ZONE_PARTIAL_SHIFT, "the zones of a cell must fit into a byte");
+
+struct touch_zones_config {
+    const uint16_t width, height;
+    // 0 disables the zone
+    const uint8_t rim_percent, right_percent, top_percent;
+};
+
+struct touch_zones {
+    uint16_t width, height;
+    uint16_t half_width, half_height;
+    // the sides start at these y and x coordinates
+    uint16_t right_start, top_start;
+    // the rim is between these two ellipses around the center
+    uint16_t inner_half_width, inner_half_height;
+    // bitmask of the zones with a size
+    uint8_t enabled;
+    uint8_t grid[TOUCH_ZONES_GRID][TOUCH_ZONES_GRID];
+};
+
+void touch_zones_init(struct touch_zones *zones, const struct touch_zones_config *config);
+
+// Bitmask of the zones that contain the position, BIT(TOUCH_ZONE_RIM) and so on
+uint8_t touch_zones_classify(const struct touch_zones *zones, uint16_t x, uint16_t y);
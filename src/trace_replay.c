@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_gestures_trace_replay
+
+#include <drivers/input_processor.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include "trace_replay.h"
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+#include <native_rtc.h>
+#include <posix_board_if.h>
+#endif
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+// every event in the trace is <time-ms type code value sync>
+#define TRACE_EVENT_CELLS 5
+
+// after the last event, give the touch end detection and all animations time to finish
+#define TRACE_SETTLE_MS 2000
+
+// an expectation that isn't set in devicetree
+#define TRACE_EXPECT_ANY -1
+
+struct trace_replay_config {
+    const struct device *processor;
+    const int32_t *events;
+    size_t events_len;
+    uint16_t repeat;
+    int32_t expect_forwarded;
+    int32_t expect_reports;
+    bool expect_unchanged_movement;
+};
+
+struct trace_replay_stats {
+    uint32_t events;
+    uint32_t forwarded;
+    uint32_t reports;
+    uint32_t decisions[TRACE_REPLAY_DECISION_COUNT];
+    // sum of the REL_X and REL_Y events in the trace, and of those passed on by the gestures
+    int32_t movement_in[2], movement_out[2];
+    uint64_t cost_total;
+    uint32_t cost_min, cost_max;
+};
+
+// traces are replayed one after the other by a single thread
+static struct trace_replay_stats stats;
+static bool replaying_event;
+static uint32_t replay_now;
+static bool replay_failed;
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+// native_sim doesn't spend simulated time while executing code, so measure host time instead
+#define COST_UNIT "ns"
+static uint32_t cost_timestamp(void) {
+    uint32_t nsec;
+    uint64_t sec;
+    native_rtc_gettime(RTC_CLOCK_REALHOSTTIME, &nsec, &sec);
+    return (uint32_t)(sec * NSEC_PER_SEC + nsec);
+}
+#else
+#define COST_UNIT "cycles"
+static uint32_t cost_timestamp(void) { return k_cycle_get_32(); }
+#endif
+
+uint32_t trace_replay_uptime_get(void) {
+    return replaying_event ? replay_now : (uint32_t)k_uptime_get();
+}
+
+void trace_replay_count_decision(enum trace_replay_decision decision) {
+    stats.decisions[decision]++;
+}
+
+void trace_replay_count_report(void) {
+    stats.reports++;
+}
+
+static void trace_replay_sum_movement(int32_t *movement, const struct input_event *event) {
+    if (event->type == INPUT_EV_REL && event->code == INPUT_REL_X) {
+        movement[0] += event->value;
+    } else if (event->type == INPUT_EV_REL && event->code == INPUT_REL_Y) {
+        movement[1] += event->value;
+    }
+}
+
+static void trace_replay_log_stats(const struct device *dev) {
+    LOG_INF("trace %s: %u events, %u forwarded, %u reports sent by gestures",
+        dev->name, stats.events, stats.forwarded, stats.reports);
+    LOG_INF("relative movement: x %d of %d, y %d of %d passed on",
+        stats.movement_out[0], stats.movement_in[0], stats.movement_out[1], stats.movement_in[1]);
+    LOG_INF("cost per event [" COST_UNIT "]: min %u, avg %u, max %u",
+        stats.events ? stats.cost_min : 0,
+        stats.events ? (uint32_t)(stats.cost_total / stats.events) : 0,
+        stats.cost_max);
+    LOG_INF("decisions: touch start %u, touch end %u, tap %u, tap drag %u, inertial cursor %u, "
+        "circular scroll %u, edge scroll %u, kinetic scroll %u",
+        stats.decisions[TRACE_REPLAY_TOUCH_START],
+        stats.decisions[TRACE_REPLAY_TOUCH_END],
+        stats.decisions[TRACE_REPLAY_TAP],
+        stats.decisions[TRACE_REPLAY_TAP_DRAG],
+        stats.decisions[TRACE_REPLAY_INERTIAL_CURSOR],
+        stats.decisions[TRACE_REPLAY_CIRCULAR_SCROLL],
+        stats.decisions[TRACE_REPLAY_EDGE_SCROLL],
+        stats.decisions[TRACE_REPLAY_KINETIC_SCROLL]);
+}
+
+static void trace_replay_check(const struct device *dev, const char *name, int32_t expected, uint32_t actual) {
+    if (expected != TRACE_EXPECT_ANY && actual != (uint32_t)expected) {
+        LOG_ERR("trace %s: expected %d %s, got %u", dev->name, expected, name, actual);
+        replay_failed = true;
+    }
+}
+
+static void trace_replay_run(const struct device *dev) {
+    const struct trace_replay_config *config = dev->config;
+    const struct zmk_input_processor_driver_api *api = config->processor->api;
+    struct zmk_input_processor_state state = {0};
+
+    stats = (struct trace_replay_stats){.cost_min = UINT32_MAX};
+
+    int64_t start = k_uptime_get();
+    int32_t first_timestamp = config->events[0];
+
+    for (size_t i = 0; i + TRACE_EVENT_CELLS <= config->events_len; i += TRACE_EVENT_CELLS) {
+        const int32_t *cells = &config->events[i];
+        int64_t due = start + (cells[0] - first_timestamp);
+        int64_t now = k_uptime_get();
+        if (due > now) {
+            k_sleep(K_MSEC(due - now));
+        }
+
+        struct input_event event = {
+            .dev = dev,
+            .type = cells[1],
+            .code = cells[2],
+            .value = cells[3],
+            .sync = cells[4],
+        };
+
+        trace_replay_sum_movement(stats.movement_in, &event);
+
+        replay_now = (uint32_t)due;
+        replaying_event = true;
+        uint32_t begin = cost_timestamp();
+        api->handle_event(config->processor, &event, 0, 0, &state);
+        uint32_t cost = cost_timestamp() - begin;
+        replaying_event = false;
+
+        stats.events++;
+        stats.cost_total += cost;
+        stats.cost_min = MIN(stats.cost_min, cost);
+        stats.cost_max = MAX(stats.cost_max, cost);
+        if (event.type != 0) {
+            stats.forwarded++;
+        }
+        trace_replay_sum_movement(stats.movement_out, &event);
+    }
+
+    k_sleep(K_MSEC(TRACE_SETTLE_MS));
+    trace_replay_log_stats(dev);
+
+    trace_replay_check(dev, "forwarded events", config->expect_forwarded, stats.forwarded);
+    trace_replay_check(dev, "reports", config->expect_reports, stats.reports);
+    for (int axis = 0; config->expect_unchanged_movement && axis < 2; axis++) {
+        if (stats.movement_out[axis] != stats.movement_in[axis]) {
+            LOG_ERR("trace %s: %d of %d pixels on %c passed on", dev->name, stats.movement_out[axis],
+                stats.movement_in[axis], "xy"[axis]);
+            replay_failed = true;
+        }
+    }
+}
+
+#define TRACE_REPLAY_DEVICE(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const trace_replay_devices[] = {
+    DT_INST_FOREACH_STATUS_OKAY(TRACE_REPLAY_DEVICE)
+};
+
+static void trace_replay_thread(void *p1, void *p2, void *p3) {
+    for (size_t i = 0; i < ARRAY_SIZE(trace_replay_devices); i++) {
+        const struct trace_replay_config *config = trace_replay_devices[i]->config;
+        for (uint16_t run = 0; run < config->repeat; run++) {
+            trace_replay_run(trace_replay_devices[i]);
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX) && IS_ENABLED(CONFIG_INPUT_GESTURES_TRACE_REPLAY_EXIT)
+    posix_exit(replay_failed ? 1 : 0);
+#endif
+}
+
+K_THREAD_DEFINE(trace_replay, CONFIG_INPUT_GESTURES_TRACE_REPLAY_STACK_SIZE, trace_replay_thread,
+                NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0,
+                CONFIG_INPUT_GESTURES_TRACE_REPLAY_DELAY_MS);
+
+#define TRACE_REPLAY_INST(n)                                                                                \
+    static const int32_t trace_replay_events_##n[] = DT_INST_PROP(n, events);                               \
+    static const struct trace_replay_config trace_replay_config_##n = {                                     \
+        .processor = DEVICE_DT_GET(DT_INST_PHANDLE(n, processor)),                                          \
+        .events = trace_replay_events_##n,                                                                  \
+        .events_len = ARRAY_SIZE(trace_replay_events_##n),                                                  \
+        .repeat = DT_INST_PROP(n, repeat),                                                                  \
+        .expect_forwarded = DT_INST_PROP_OR(n, expect_forwarded, TRACE_EXPECT_ANY),                         \
+        .expect_reports = DT_INST_PROP_OR(n, expect_reports, TRACE_EXPECT_ANY),                             \
+        .expect_unchanged_movement = DT_INST_PROP(n, expect_unchanged_movement),                            \
+    };                                                                                                      \
+    DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, &trace_replay_config_##n, POST_KERNEL,                       \
+                          CONFIG_INPUT_GESTURES_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(TRACE_REPLAY_INST)
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+enum trace_replay_decision {
+    TRACE_REPLAY_TOUCH_START,
+    TRACE_REPLAY_TOUCH_END,
+    TRACE_REPLAY_TAP,
+    TRACE_REPLAY_TAP_DRAG,
+    TRACE_REPLAY_INERTIAL_CURSOR,
+    TRACE_REPLAY_CIRCULAR_SCROLL,
+    TRACE_REPLAY_EDGE_SCROLL,
+    TRACE_REPLAY_KINETIC_SCROLL,
+    TRACE_REPLAY_DECISION_COUNT,
+};
+
+#include "latency_trace.h"
+
+#if IS_ENABLED(CONFIG_INPUT_GESTURES_TRACE_REPLAY)
+
+// While a trace is replayed, this is the timestamp of the replayed event instead of the uptime.
+uint32_t trace_replay_uptime_get(void);
+void trace_replay_count_decision(enum trace_replay_decision decision);
+void trace_replay_count_report(void);
+
+#else
+
+static inline uint32_t trace_replay_uptime_get(void) { return k_uptime_get(); }
+static inline void trace_replay_count_decision(enum trace_replay_decision decision) {}
+static inline void trace_replay_count_report(void) {}
+
+#endif
+
+// Called by the gestures when they decide something, and right before they send a report
+static inline void trace_replay_note_decision(enum trace_replay_decision decision) {
+    trace_replay_count_decision(decision);
+    latency_trace_decision(decision);
+}
+
+static inline void trace_replay_note_report(void) {
+    trace_replay_count_report();
+    latency_trace_report();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <drivers/input_processor.h>
+#include <zephyr/logging/log.h>
+
+#include "input_processor_gestures.h"
+#include "two_finger_scroll.h"
+
+LOG_MODULE_DECLARE(gestures, CONFIG_ZMK_LOG_LEVEL);
+
+static int two_finger_scroll_handle_cancel(const struct device *dev) {
+    struct gesture_data *data = (struct gesture_data *)dev->data;
+
+    data->two_finger_scroll.is_tracking = false;
+    return 0;
+}
+
+static int two_finger_scroll_handle_frame(const struct device *dev, const struct touch_slots *slots) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    struct two_finger_scroll_data *data = &((struct gesture_data *)dev->data)->two_finger_scroll;
+    uint8_t first, second;
+
+    if (touch_slots_count(slots) != 2) {
+        return two_finger_scroll_handle_cancel(dev);
+    }
+
+    touch_slots_first_two(slots, &first, &second);
+    int32_t sum_x = slots->x[first] + slots->x[second];
+    int32_t sum_y = slots->y[first] + slots->y[second];
+
+    if (!data->is_tracking || data->first != first || data->second != second) {
+        LOG_DBG("two fingers down in slots %d and %d", first, second);
+        data->is_tracking = true;
+        data->first = first;
+        data->second = second;
+        data->previous_sum_x = sum_x;
+        data->previous_sum_y = sum_y;
+        scroll_accumulator_reset(&data->horizontal);
+        scroll_accumulator_reset(&data->vertical);
+        return 0;
+    }
+
+    // moving up or right scrolls up or right, like edge scroll
+    int32_t delta_x = sum_x - data->previous_sum_x, delta_y = sum_y - data->previous_sum_y;
+    int32_t movement_x = GESTURES_REPORT_X(delta_x, delta_y);
+    int32_t movement_y = -GESTURES_REPORT_Y(delta_x, delta_y);
+    data->previous_sum_x = sum_x;
+    data->previous_sum_y = sum_y;
+
+    // the sum moves twice as far as the fingers
+    int32_t per_tick = 2 * config->two_finger_scroll.pixels_per_tick;
+    bool scrolled = gestures_scroll(dev, NULL, &data->horizontal, INPUT_REL_HWHEEL,
+                                    fix16_from_int(movement_x) / per_tick);
+    scrolled |= gestures_scroll(dev, NULL, &data->vertical, INPUT_REL_WHEEL, fix16_from_int(movement_y) / per_tick);
+
+    return scrolled ? GESTURE_CLAIM : 0;
+}
+
+static int two_finger_scroll_init(const struct device *dev) {
+    struct gesture_config *config = (struct gesture_config *)dev->config;
+    LOG_DBG("two_finger_scroll: pixels_per_tick: %d", config->two_finger_scroll.pixels_per_tick);
+    return 0;
+}
+
+// Two fingers are never a single-finger gesture, so both multi-touch gestures come first
+const struct gesture_recognizer two_finger_scroll_recognizer = {
+    .name = "two finger scroll",
+    .priority = 45,
+    .stage = GESTURE_STATS_TWO_FINGER_SCROLL,
+    .init = two_finger_scroll_init,
+    .frame = two_finger_scroll_handle_frame,
+    .cancel = two_finger_scroll_handle_cancel,
+};
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "input_processor_gestures.h"
+
+struct two_finger_scroll_data {
+    bool is_tracking;
+    uint8_t first, second;
+    // sum of the positions of both fingers, that is twice their center
+    int32_t previous_sum_x, previous_sum_y;
+    struct scroll_accumulator horizontal, vertical;
+    gesture_data *all;
+};
+
+struct two_finger_scroll_config {
+    const uint16_t pixels_per_tick;
+};
+
+extern const struct gesture_recognizer two_finger_scroll_recognizer;
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2025 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include "gesture_math.h"
+
+ZTEST(gesture_math, test_hypot) {
+    zassert_equal(fix16_hypot(3, 4), fix16_from_int(5));
+    zassert_equal(fix16_hypot(-3, -4), fix16_from_int(5));
+    zassert_equal(fix16_hypot(0, 0), 0);
+    // keeps the fraction: sqrt(2) = 1.41421
+    zassert_within(fix16_hypot(1, 1), 92682, 1);
+}
+
+// lengths from 32768 on don't fit into fix16_t, even when their square still fits into 32 bits
+ZTEST(gesture_math, test_hypot_saturates) {
+    zassert_equal(fix16_hypot(32767, 0), fix16_from_int(32767));
+    zassert_equal(fix16_hypot(32768, 0), FIX16_MAX);
+    zassert_equal(fix16_hypot(40000, 30000), FIX16_MAX);
+    zassert_equal(fix16_hypot(65535, 0), FIX16_MAX);
+    zassert_equal(fix16_hypot(INT32_MIN, INT32_MIN), FIX16_MAX);
+}
+
+ZTEST(gesture_math, test_length) {
+    zassert_equal(fix16_length(fix16_from_int(3), fix16_from_int(-4)), fix16_from_int(5));
+    zassert_equal(fix16_length(fix16_from_int(30000), fix16_from_int(30000)), FIX16_MAX);
+}
+
+ZTEST_SUITE(gesture_math, NULL, NULL, NULL, NULL, NULL);